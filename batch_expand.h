@@ -0,0 +1,244 @@
+/**
+ * @file batch_expand.h
+ * @brief Struct-of-arrays expansion kernel for blocks of packed 4x4 nodes
+ *
+ * The engines expand one State at a time: a loop over the legal moves of
+ * the blank (successor_table.h), a string copy per child and a full
+ * heuristic recomputation. This kernel expands a whole block instead. A
+ * NodeBlock keeps each field in its own array (boards, blank cells, g, h,
+ * pruning state), and the expansion runs in two passes over those arrays:
+ *
+ *   1. Every (node, move) slot is computed unconditionally from tables:
+ *      the target cell of the move (the blank itself when the move leaves
+ *      the board), the child board by XOR-ing the moved tile into place,
+ *      and h updated by the Manhattan delta of that one tile. Invalid slots
+ *      are flagged instead of skipped, so the loop has no data-dependent
+ *      control flow and the compiler can vectorise it.
+ *   2. The valid slots are compacted in place: every slot is copied to the
+ *      output cursor, which advances by the flag (0 or 1).
+ *
+ * Children record their parent index so callers can carry extra data. A
+ * kernel instance holds only read-only tables and is shared by all threads;
+ * each thread expands into its own output block.
+ *
+ * expandPartial() is the EPEA* variant: every move changes Manhattan h by
+ * exactly +-1, so the f increase of a child is 0 or 2 and hDelta doubles as
+ * the operator-selection table (blank cell, move, moved tile). Only the
+ * children whose f increase equals the node's `surplus` are kept, and the
+ * node learns the next larger increase it still has to generate.
+ *
+ * Tiles are numbered as in packed_board.h (blank is 15). h is the Manhattan
+ * distance to the goal given to the constructor, by default
+ * ABCDEFGHIJKLMNO# (tile t in cell t); any other arrangement of the same
+ * tiles only changes the hDelta table.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef BATCH_EXPAND_H
+#define BATCH_EXPAND_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "move_pruning_table.h"
+#include "packed_board.h"
+#include "successor_table.h"
+
+/**
+ * @brief Nodes of one block, one array per field
+ */
+struct NodeBlock {
+      std::vector<PackedBoard> board;
+      std::vector<int32_t> g;
+      std::vector<int32_t> h;
+      std::vector<uint8_t> blankPos;
+      std::vector<uint8_t> pruneState;
+      std::vector<uint32_t> parent;  // Index in the expanded block (children only)
+      std::vector<uint8_t> surplus;  // EPEA*: f(child) - f(node) to generate (parents only)
+      std::vector<uint8_t> valid;    // Expansion scratch: slot holds a real child
+
+      size_t size() const { return board.size(); }
+
+      bool empty() const { return board.empty(); }
+
+      void clear() { resize(0); }
+
+      void resize(size_t n) {
+            board.resize(n);
+            g.resize(n);
+            h.resize(n);
+            blankPos.resize(n);
+            pruneState.resize(n);
+            parent.resize(n);
+            surplus.resize(n);
+      }
+
+      void push(PackedBoard b, int blank, int gValue, int hValue, int prune = MOVE_PRUNING_START,
+                int surplusValue = 0) {
+            board.push_back(b);
+            g.push_back(gValue);
+            h.push_back(hValue);
+            blankPos.push_back(blank);
+            pruneState.push_back(prune);
+            parent.push_back(0);
+            surplus.push_back(surplusValue);
+      }
+};
+
+/**
+ * @brief Blank cell of a packed board without a loop: the only nibble equal to 15
+ */
+inline int blockBlankPos(PackedBoard board) {
+      uint64_t ones = board & (board >> 1) & (board >> 2) & (board >> 3) & 0x1111111111111111ULL;
+      return __builtin_ctzll(ones) >> 2;
+}
+
+// ABCDEFGHIJKLMNO# packed: tile t in cell t
+const PackedBoard BATCH_CANONICAL_GOAL = 0xFEDCBA9876543210ULL;
+
+class BatchExpander {
+public:
+      explicit BatchExpander(PackedBoard goal = BATCH_CANONICAL_GOAL) {
+            for (int pos = 0; pos < 16; pos++) goalCell[packedTile(goal, pos)] = pos;
+            const SuccessorTable& table = SuccessorTable::square(4);
+            for (int blank = 0; blank < 16; blank++) {
+                  for (int move = 0; move < 4; move++) {
+                        bool inside = table.target(blank, move) >= 0;
+                        int target = inside ? table.target(blank, move) : blank;
+                        int slot = blank * 4 + move;
+                        moveTarget[slot] = target;
+                        moveInside[slot] = inside;
+                        for (int tile = 0; tile < 16; tile++) {
+                              // The tile at target slides into the blank cell
+                              hDelta[slot][tile] = tile == PACKED_BLANK ? 0 : distance(tile, blank) - distance(tile, target);
+                        }
+                  }
+            }
+            for (int state = 0; state < MOVE_PRUNING_STATES; state++) {
+                  for (int move = 0; move < 4; move++) {
+                        int next = MOVE_PRUNING_NEXT[state][move];
+                        pruneNext[state * 4 + move] = next < 0 ? 0 : next;
+                        pruneAllowed[state * 4 + move] = next >= 0;
+                  }
+            }
+      }
+
+      /**
+       * @brief Manhattan distance of a packed board to the goal
+       */
+      int manhattan(PackedBoard board) const {
+            int h = 0;
+            for (int pos = 0; pos < 16; pos++) {
+                  int tile = packedTile(board, pos);
+                  if (tile != PACKED_BLANK) h += distance(tile, pos);
+            }
+            return h;
+      }
+
+      /**
+       * @brief Writes every non-pruned child of every node of `in` into `out`
+       * @return number of children
+       */
+      size_t expand(const NodeBlock& in, NodeBlock& out) const {
+            return expandSlots(in, out, [](size_t, int allowed, int) { return allowed; });
+      }
+
+      static const uint8_t NO_SURPLUS = 0xFF;  // expandPartial: node fully expanded
+
+      /**
+       * @brief EPEA* expansion: writes the children of `in` whose f exceeds their
+       *        parent's by exactly in.surplus of the parent
+       * @param nextSurplus Output, per parent: the next f increase among its
+       *        remaining children, or NO_SURPLUS if none is left
+       * @return number of children
+       */
+      size_t expandPartial(const NodeBlock& in, NodeBlock& out, std::vector<uint8_t>& nextSurplus) const {
+            nextSurplus.assign(in.size(), (uint8_t)NO_SURPLUS);
+            const uint8_t* __restrict wanted = in.surplus.data();
+            uint8_t* __restrict next = nextSurplus.data();
+            return expandSlots(in, out, [wanted, next](size_t i, int allowed, int increase) {
+                  int later = allowed && increase > wanted[i] ? increase : (int)NO_SURPLUS;
+                  next[i] = later < next[i] ? later : next[i];
+                  return allowed & (increase == wanted[i]);
+            });
+      }
+
+private:
+      /**
+       * @brief The two passes shared by expand() and expandPartial()
+       * @param select select(node, allowed, increase) gives the valid flag of a
+       *        slot from its move being legal and the f increase of its child
+       */
+      template <class Select>
+      size_t expandSlots(const NodeBlock& in, NodeBlock& out, Select select) const {
+            size_t n = in.size();
+            out.resize(n * 4);
+            out.valid.resize(n * 4);
+
+            const PackedBoard* __restrict inBoard = in.board.data();
+            const int32_t* __restrict inG = in.g.data();
+            const int32_t* __restrict inH = in.h.data();
+            const uint8_t* __restrict inBlank = in.blankPos.data();
+            const uint8_t* __restrict inPrune = in.pruneState.data();
+            PackedBoard* __restrict outBoard = out.board.data();
+            int32_t* __restrict outG = out.g.data();
+            int32_t* __restrict outH = out.h.data();
+            uint8_t* __restrict outBlank = out.blankPos.data();
+            uint8_t* __restrict outPrune = out.pruneState.data();
+            uint32_t* __restrict outParent = out.parent.data();
+            uint8_t* __restrict outValid = out.valid.data();
+
+            // Pass 1: all 4 slots of every node, no branches
+            for (size_t i = 0; i < n; i++) {
+                  PackedBoard board = inBoard[i];
+                  int blank = inBlank[i];
+                  int prune = inPrune[i];
+                  for (int move = 0; move < 4; move++) {
+                        size_t slot = i * 4 + move;
+                        int moveSlot = blank * 4 + move;
+                        int target = moveTarget[moveSlot];
+                        uint64_t tile = (board >> (4 * target)) & 0xF;
+                        uint64_t diff = tile ^ PACKED_BLANK;
+                        int allowed = moveInside[moveSlot] & pruneAllowed[prune * 4 + move];
+                        outBoard[slot] = board ^ (diff << (4 * blank)) ^ (diff << (4 * target));
+                        outG[slot] = inG[i] + 1;
+                        outH[slot] = inH[i] + hDelta[moveSlot][tile];
+                        outBlank[slot] = target;
+                        outPrune[slot] = pruneNext[prune * 4 + move];
+                        outParent[slot] = i;
+                        outValid[slot] = select(i, allowed, 1 + hDelta[moveSlot][tile]);
+                  }
+            }
+
+            // Pass 2: in-place compaction (the cursor never passes the slot)
+            size_t count = 0;
+            for (size_t slot = 0; slot < n * 4; slot++) {
+                  outBoard[count] = outBoard[slot];
+                  outG[count] = outG[slot];
+                  outH[count] = outH[slot];
+                  outBlank[count] = outBlank[slot];
+                  outPrune[count] = outPrune[slot];
+                  outParent[count] = outParent[slot];
+                  count += outValid[slot];
+            }
+            out.resize(count);
+            return count;
+      }
+
+      int distance(int tile, int pos) const {
+            int goal = goalCell[tile];
+            return std::abs(goal / 4 - pos / 4) + std::abs(goal % 4 - pos % 4);
+      }
+
+      uint8_t goalCell[16];       // [tile] cell of the tile in the goal
+
+      uint8_t moveTarget[64];     // [blank * 4 + move] cell of the moved tile (blank if outside)
+      uint8_t moveInside[64];
+      int8_t hDelta[64][16];      // [blank * 4 + move][tile] change of h
+      uint8_t pruneNext[MOVE_PRUNING_STATES * 4];
+      uint8_t pruneAllowed[MOVE_PRUNING_STATES * 4];
+};
+
+#endif // BATCH_EXPAND_H
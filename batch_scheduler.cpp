@@ -0,0 +1,398 @@
+/**
+ * @file batch_scheduler.cpp
+ * @brief Batch solver that mixes one-thread-per-puzzle and gang-per-puzzle
+ *
+ * One puzzle on 4 threads reaches about 52% efficiency, while a queue of
+ * puzzles solved one per thread scales almost perfectly but leaves a hard
+ * outlier on a single core for the whole batch. This scheduler does both:
+ *
+ *   1. Every instance gets a difficulty estimate: the IDA* nodes predicted
+ *      by effort_predictor.h (stratified sampling of the search tree), or
+ *      with --estimate h its Manhattan distance, a lower bound that ignores
+ *      how fast the tree grows.
+ *   2. Instances at or above the hard threshold (by default the top 10% of
+ *      the batch) are solved by a gang: the root is split into subtrees and
+ *      every IDA* iteration hands those subtrees to whichever threads are
+ *      helping at the moment (the stepwise IDA* of puzzle_solver.h). The
+ *      rest are solved by single-threaded IDA* (PuzzleSolver::run).
+ *   3. Threads 0..G-1 prefer gang work, the others prefer easy instances.
+ *      Any thread that finds its preferred queue empty helps the oldest
+ *      running gang, so threads freed by finished easy puzzles move to the
+ *      stragglers while they run (rebalancing happens between subtrees).
+ *   4. Both queues are ordered hardest first (longest-processing-time
+ *      first), which keeps the last puzzle from starting late.
+ *
+ * Input: one instance per line, "board [depth]" (instance_generator.cpp
+ * format; a given depth is checked). Output: one line per instance in input
+ * order "board moves mode threads ms", then throughput and latency
+ * percentiles (latency = completion time since the batch started).
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -pthread -o batch_scheduler batch_scheduler.cpp
+ *
+ * Usage:
+ *   batch_scheduler [--threads T] [--gang G] [--hard-h H | --hard-fraction F]
+ *                   [--estimate predicted|h] [--mode adaptive|single|gang] < corpus.txt
+ *
+ *   --threads T        Worker threads (default: all cores)
+ *   --gang G           Threads that prefer gang work (default T/2, at least 1)
+ *   --hard-h H         Instances with h >= H are solved by a gang
+ *   --hard-fraction F  Otherwise the hardest fraction F of the batch (default 0.1)
+ *   --estimate         Difficulty used for the fraction and the queue order:
+ *                      predicted (default) or h
+ *   --mode             adaptive (default), single (every instance on one
+ *                      thread) or gang (every instance on all threads)
+ *
+ * Example:
+ *   instance_generator walk 4 20 30-40 | batch_scheduler --threads 8
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "effort_predictor.h"
+#include "puzzle_solver.h"
+
+using namespace std;
+using namespace chrono;
+
+
+// =============================================================================
+// DIFFICULTY AND GANG JOBS
+// =============================================================================
+
+int boardSide(const string& board) {
+      return board.size() == 9 ? 3 : (board.size() == 25 ? 5 : 4);
+}
+
+/**
+ * @brief Manhattan distance to the canonical goal (tile t belongs in cell t)
+ */
+int manhattan(const string& board) {
+      int n = boardSide(board), h = 0;
+      for (int pos = 0; pos < (int)board.size(); pos++) {
+            if (board[pos] == '#') continue;
+            int tile = board[pos] - 'A';
+            h += abs(pos / n - tile / n) + abs(pos % n - tile % n);
+      }
+      return h;
+}
+
+/**
+ * @brief One hard instance; any number of threads help its IDA* at a time
+ */
+struct GangJob {
+      int instance;
+      PuzzleSolver* solver;
+      int active;            // Threads inside solver->help()
+      bool completed;        // A help() call completed the search
+      vector<bool> helpers;  // Threads that worked on this job
+      steady_clock::time_point start;
+
+      GangJob() : solver(nullptr), active(0), completed(false) {}
+      ~GangJob() { delete solver; }
+};
+
+// =============================================================================
+// SCHEDULER
+// =============================================================================
+
+struct Instance {
+      string board;
+      int heuristic;    // Manhattan distance
+      int expected;     // Depth given in the corpus, -1 if none
+      double estimate;  // Predicted IDA* nodes, or h with --estimate h
+      bool hard;
+      int solution;
+      int threadsUsed;
+      double solveMs;   // From start of its search to completion
+      double latencyMs; // From start of the batch to completion
+};
+
+class BatchScheduler {
+public:
+      BatchScheduler(vector<Instance>& list, int threads, int gangThreads)
+            : instances(list), numThreads(threads), gangSize(gangThreads) {
+            for (size_t i = 0; i < instances.size(); i++) {
+                  (instances[i].hard ? hardQueue : easyQueue).push_back(i);
+            }
+            // Longest (estimated) first
+            auto harder = [this](int a, int b) { return instances[a].estimate > instances[b].estimate; };
+            stable_sort(hardQueue.begin(), hardQueue.end(), harder);
+            stable_sort(easyQueue.begin(), easyQueue.end(), harder);
+      }
+
+      void run() {
+            batchStart = steady_clock::now();
+            vector<thread> workers;
+            for (int id = 0; id < numThreads; id++) {
+                  workers.push_back(thread([this, id]() { workerLoop(id); }));
+            }
+            for (thread& t : workers) t.join();
+      }
+
+private:
+      void workerLoop(int id) {
+            bool prefersGang = id < gangSize;
+            while (true) {
+                  unique_lock<mutex> lock(mutex_);
+                  GangJob* job = nullptr;
+                  int easy = -1;
+
+                  if (prefersGang) {
+                        job = jobWithWork();
+                        if (!job && !hardQueue.empty()) job = startJob();
+                        if (!job && !easyQueue.empty()) easy = popEasy();
+                  } else {
+                        if (!easyQueue.empty()) easy = popEasy();
+                        if (easy < 0) job = jobWithWork();
+                        if (easy < 0 && !job && !hardQueue.empty()) job = startJob();
+                  }
+
+                  if (easy >= 0) {
+                        lock.unlock();
+                        solveEasy(easy);
+                        continue;
+                  }
+                  if (job) {
+                        runSubtree(job, id, lock);
+                        continue;
+                  }
+                  if (!hardQueue.empty() || !easyQueue.empty()) continue;  // solved while splitting
+                  if (jobs.empty()) return;
+
+                  // Every subtree of the running gangs is taken: wait for the
+                  // next iteration or for a gang to finish
+                  workAvailable.wait(lock);
+            }
+      }
+
+      int popEasy() {
+            int index = easyQueue.front();
+            easyQueue.pop_front();
+            return index;
+      }
+
+      // Oldest running gang that still has unclaimed subtrees
+      GangJob* jobWithWork() {
+            for (size_t i = 0; i < jobs.size(); i++) {
+                  if (jobs[i]->solver->hasWork()) return jobs[i];
+            }
+            return nullptr;
+      }
+
+      GangJob* startJob() {
+            GangJob* job = new GangJob();
+            job->instance = hardQueue.front();
+            hardQueue.pop_front();
+            job->helpers.assign(numThreads, false);
+            job->start = steady_clock::now();
+
+            // Solved or rejected while splitting: nothing to share
+            job->solver = new PuzzleSolver(instances[job->instance].board);
+            if (!job->solver->begin(16 * numThreads)) {
+                  finishJob(job, 1);
+                  delete job;
+                  return nullptr;
+            }
+            jobs.push_back(job);
+            return job;
+      }
+
+      void solveEasy(int index) {
+            auto start = steady_clock::now();
+            SolveResult result = PuzzleSolver::run(instances[index].board);
+            lock_guard<mutex> lock(mutex_);
+            Instance& instance = instances[index];
+            instance.solution = result.moves;
+            instance.threadsUsed = 1;
+            instance.solveMs = duration<double, milli>(steady_clock::now() - start).count();
+            instance.latencyMs = duration<double, milli>(steady_clock::now() - batchStart).count();
+      }
+
+      // Called with the lock held; searches one subtree with the lock released
+      void runSubtree(GangJob* job, int id, unique_lock<mutex>& lock) {
+            job->active++;
+            job->helpers[id] = true;
+            lock.unlock();
+
+            bool completed = job->solver->help();
+
+            lock.lock();
+            job->active--;
+            if (completed) job->completed = true;
+            if (job->completed) {
+                  // The last helper to leave retires the job
+                  if (job->active == 0) retireJob(job);
+            } else if (job->solver->hasWork()) {
+                  workAvailable.notify_all();  // a new iteration started
+            }
+      }
+
+      void retireJob(GangJob* job) {
+            int helpers = count(job->helpers.begin(), job->helpers.end(), true);
+            finishJob(job, helpers);
+            jobs.erase(find(jobs.begin(), jobs.end(), job));
+            delete job;
+            workAvailable.notify_all();
+      }
+
+      void finishJob(GangJob* job, int helpers) {
+            Instance& instance = instances[job->instance];
+            instance.solution = job->solver->result().moves;
+            instance.threadsUsed = helpers;
+            instance.solveMs = duration<double, milli>(steady_clock::now() - job->start).count();
+            instance.latencyMs = duration<double, milli>(steady_clock::now() - batchStart).count();
+      }
+
+      vector<Instance>& instances;
+      int numThreads;
+      int gangSize;
+      mutex mutex_;
+      condition_variable workAvailable;
+      deque<int> hardQueue;
+      deque<int> easyQueue;
+      vector<GangJob*> jobs;
+      steady_clock::time_point batchStart;
+};
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+double percentile(vector<double> values, double p) {
+      if (values.empty()) return 0;
+      sort(values.begin(), values.end());
+      return values[(size_t)(p * (values.size() - 1) + 0.5)];
+}
+
+int main(int argc, char* argv[]) {
+      int numThreads = thread::hardware_concurrency();
+      int gangSize = -1;
+      int hardH = -1;
+      double hardFraction = 0.1;
+      bool predictEffort = true;
+      string mode = "adaptive";
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                  numThreads = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--gang") == 0 && i + 1 < argc) {
+                  gangSize = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--hard-h") == 0 && i + 1 < argc) {
+                  hardH = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--hard-fraction") == 0 && i + 1 < argc) {
+                  hardFraction = atof(argv[++i]);
+            } else if (strcmp(argv[i], "--estimate") == 0 && i + 1 < argc) {
+                  predictEffort = strcmp(argv[++i], "h") != 0;
+            } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+                  mode = argv[++i];
+            } else {
+                  cerr << "Usage: " << argv[0] << " [--threads T] [--gang G] [--hard-h H | --hard-fraction F]"
+                       << " [--estimate predicted|h] [--mode adaptive|single|gang] < corpus.txt" << endl;
+                  return 1;
+            }
+      }
+      if (numThreads < 1) numThreads = 1;
+      if (gangSize < 1) gangSize = max(1, numThreads / 2);
+      if (gangSize > numThreads) gangSize = numThreads;
+      if (mode != "adaptive" && mode != "single" && mode != "gang") {
+            cerr << "Error: unknown mode " << mode << endl;
+            return 1;
+      }
+
+      // Read the batch
+      vector<Instance> instances;
+      string line;
+      while (getline(cin, line)) {
+            istringstream tokens(line);
+            Instance instance;
+            if (!(tokens >> instance.board)) continue;
+            string depth;
+            instance.expected = (tokens >> depth && depth != "?") ? atoi(depth.c_str()) : -1;
+
+            string error;
+            if (!PuzzleSolver::accepts(instance.board, SolveOptions(), error)) {
+                  cerr << "Error: invalid or unsolvable board " << instance.board << " (" << error << ")" << endl;
+                  return 1;
+            }
+            instance.heuristic = manhattan(instance.board);
+            if (predictEffort) {
+                  EffortPredictor predictor(boardSide(instance.board));
+                  instance.estimate = predictor.predict(instance.board).idaNodes;
+            } else {
+                  instance.estimate = instance.heuristic;
+            }
+            instance.solution = -1;
+            instance.threadsUsed = 0;
+            instances.push_back(instance);
+      }
+      if (instances.empty()) {
+            cerr << "Error: no instances on stdin" << endl;
+            return 1;
+      }
+
+      // Difficulty threshold: on h if given, else on the hardest fraction of the estimates
+      double hardEstimate = 0;
+      if (hardH < 0) {
+            vector<double> estimates;
+            for (size_t i = 0; i < instances.size(); i++) estimates.push_back(instances[i].estimate);
+            sort(estimates.rbegin(), estimates.rend());
+            size_t hardCount = (size_t)(hardFraction * instances.size() + 0.5);
+            hardEstimate = hardCount == 0 ? HUGE_VAL : estimates[hardCount - 1];
+      }
+      if (mode == "gang") gangSize = numThreads;
+      for (size_t i = 0; i < instances.size(); i++) {
+            Instance& instance = instances[i];
+            if (mode != "adaptive") instance.hard = mode == "gang";
+            else if (hardH >= 0) instance.hard = instance.heuristic >= hardH;
+            else instance.hard = instance.estimate >= hardEstimate;
+      }
+
+      auto start = steady_clock::now();
+      BatchScheduler scheduler(instances, numThreads, gangSize);
+      scheduler.run();
+      double totalMs = duration<double, milli>(steady_clock::now() - start).count();
+
+      // Report
+      int mismatches = 0, hardCount = 0;
+      vector<double> latencies;
+      for (size_t i = 0; i < instances.size(); i++) {
+            const Instance& instance = instances[i];
+            cout << instance.board << " " << instance.solution << " " << (instance.hard ? "gang" : "single")
+                 << " " << instance.threadsUsed << " " << fixed << setprecision(2) << instance.solveMs << endl;
+            cout.unsetf(ios::fixed);
+            if (instance.expected >= 0 && instance.expected != instance.solution) mismatches++;
+            if (instance.hard) hardCount++;
+            latencies.push_back(instance.latencyMs);
+      }
+
+      cerr << fixed << setprecision(2);
+      cerr << "Mode: " << mode << ", threads: " << numThreads << ", gang threads: " << gangSize
+           << ", gang instances: " << hardCount << "/" << instances.size() << endl;
+      cerr << "Total: " << totalMs << " ms, throughput: " << instances.size() * 1000.0 / totalMs
+           << " instances/s" << endl;
+      cerr << "Latency ms: p50=" << percentile(latencies, 0.5) << " p95=" << percentile(latencies, 0.95)
+           << " p99=" << percentile(latencies, 0.99) << " max=" << percentile(latencies, 1.0) << endl;
+      if (mismatches > 0) {
+            cerr << "Error: " << mismatches << " solutions differ from the corpus depth" << endl;
+            return 1;
+      }
+      return 0;
+}
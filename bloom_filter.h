@@ -0,0 +1,120 @@
+/**
+ * @file bloom_filter.h
+ * @brief Fixed-size concurrent blocked Bloom filter for 64-bit state keys
+ *
+ * Used by the BFS solvers to remember the older layers of a search in a
+ * fixed number of bytes. A lookup never misses a state that was inserted but
+ * may report a state that was not (false positive), so a BFS that trusts the
+ * filter can drop a few genuinely new states; the solvers count those
+ * rejections and can verify them against an exact set.
+ *
+ * Blocked layout: all the bits of one key live in the same 64-byte block, so
+ * a lookup or insert touches a single cache line. Inserts set bits with an
+ * atomic OR and may run concurrently with each other and with lookups.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+class BlockedBloomFilter {
+public:
+      /**
+       * @brief Creates a filter using at most the given memory budget
+       * @param bytes Memory budget; the block count is rounded down to a power of two
+       * @param hashes Bits set per key (all inside one block, at most 7)
+       */
+      explicit BlockedBloomFilter(size_t bytes, int hashes = 6)
+            : numHashes(hashes < 1 ? 1 : (hashes > 7 ? 7 : hashes)), inserted(0) {
+            size_t count = 1;
+            int bits = 0;
+            while (count * 2 * BLOCK_BYTES <= bytes) {
+                  count *= 2;
+                  bits++;
+            }
+            numBlocks = count;
+            shift = 64 - bits;
+            words.reset(new std::atomic<uint64_t>[count * WORDS_PER_BLOCK]);
+            for (size_t i = 0; i < count * WORDS_PER_BLOCK; i++) {
+                  words[i].store(0, std::memory_order_relaxed);
+            }
+      }
+
+      /**
+       * @brief Adds a key (thread-safe)
+       */
+      void insert(uint64_t key) {
+            uint64_t h = mix(key);
+            std::atomic<uint64_t>* block = &words[blockIndex(h) * WORDS_PER_BLOCK];
+            for (int i = 0; i < numHashes; i++) {
+                  int bit = (h >> (9 * i)) & 511;
+                  block[bit >> 6].fetch_or((uint64_t)1 << (bit & 63), std::memory_order_relaxed);
+            }
+            inserted.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief false if the key was never inserted; true if it probably was
+       */
+      bool mayContain(uint64_t key) const {
+            uint64_t h = mix(key);
+            const std::atomic<uint64_t>* block = &words[blockIndex(h) * WORDS_PER_BLOCK];
+            for (int i = 0; i < numHashes; i++) {
+                  int bit = (h >> (9 * i)) & 511;
+                  if (!(block[bit >> 6].load(std::memory_order_relaxed) & ((uint64_t)1 << (bit & 63)))) {
+                        return false;
+                  }
+            }
+            return true;
+      }
+
+      size_t bytes() const { return numBlocks * BLOCK_BYTES; }
+
+      uint64_t size() const { return inserted.load(std::memory_order_relaxed); }
+
+      /**
+       * @brief Expected false-positive rate for the current number of keys
+       *        (standard estimate (1 - e^(-k n / m))^k)
+       */
+      double estimatedFalsePositiveRate() const {
+            double bitsTotal = 8.0 * bytes();
+            double fill = 1.0 - std::exp(-(double)numHashes * size() / bitsTotal);
+            return std::pow(fill, numHashes);
+      }
+
+private:
+      static const int BLOCK_BYTES = 64;
+      static const int WORDS_PER_BLOCK = BLOCK_BYTES / 8;
+
+      // splitmix64 finalizer: every key bit affects every hash bit
+      static uint64_t mix(uint64_t key) {
+            key ^= key >> 30;
+            key *= 0xBF58476D1CE4E5B9ULL;
+            key ^= key >> 27;
+            key *= 0x94D049BB133111EBULL;
+            key ^= key >> 31;
+            return key;
+      }
+
+      // Block from the high bits, bit positions from the low 9-bit groups
+      size_t blockIndex(uint64_t h) const {
+            if (shift == 64) return 0;
+            return (size_t)((h * 0x9E3779B97F4A7C15ULL) >> shift);
+      }
+
+      std::unique_ptr<std::atomic<uint64_t>[]> words;
+      size_t numBlocks;
+      int shift;
+      int numHashes;
+      std::atomic<uint64_t> inserted;
+};
+
+#endif // BLOOM_FILTER_H
@@ -7,6 +7,7 @@
  */
 #include <iostream>
 #include <string>
+#include "successor_table.h"
 
 using namespace std;
 
@@ -18,15 +19,15 @@ void listAvailable(const string &board){
   // Find position of '#' in the string (16 characters, 4x4 board)
   int blankPos = board.find('#');
   
-  // Convert 1D position to 2D coordinates
-  int row = blankPos / 4;
-  int col = blankPos % 4;
+  // Legal moves of that cell, as a bitmask (successor_table.h)
+  unsigned legal = SuccessorTable::square(4).mask(blankPos);
   
-  // Check and print available moves in order: UP, DOWN, LEFT, RIGHT
-  if (row > 0) cout << "UP" << endl;      // Can move up if not in first row
-  if (row < 3) cout << "DOWN" << endl;    // Can move down if not in last row
-  if (col > 0) cout << "LEFT" << endl;    // Can move left if not in first column
-  if (col < 3) cout << "RIGHT";           // Can move right if not in last column (no endl on last)
+  // Print available moves in order: UP, DOWN, LEFT, RIGHT
+  for (int move = MOVE_UP; move <= MOVE_RIGHT; move++) {
+    if (!(legal & (1u << move))) continue;
+    cout << SuccessorTable::moveName(move);
+    if (move != MOVE_RIGHT) cout << endl;  // No endl on the last one
+  }
 }
 /**
  * @brief Main function - program entry point
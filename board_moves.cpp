@@ -3,7 +3,9 @@
  * @brief 4x4 Sliding Puzzle Move Simulator
  */
 #include <iostream>
+#include <string>
 #include <vector>
+#include "successor_table.h"
 
 using namespace std;
 
@@ -22,37 +24,26 @@ void print_board(vector<vector<char>> board){
 /**
  * @brief Executes a move on the puzzle board by sliding the empty space
  * 
- * Searches for the empty space ('#') and attempts to move it in the specified
- * direction by swapping with the adjacent tile. The move is only executed if
- * it remains within the board boundaries.
+ * Searches for the empty space ('#') and moves it in the specified direction
+ * by swapping with the adjacent tile. The target cell comes from the
+ * successor table, so a move that would leave the board is not executed.
  */
 void doMove(vector<vector<char>> &board, string move){
-      for (int i = 0; i < 4; i++){
-        for (int j = 0; j < 4; j++){
-          if (board[i][j] == '#'){
-            if (move == "DOWN" && i < 3){
-              char temp = board[i + 1][j];
-              board[i][j] = temp;
-              board[i + 1][j] = '#';
-              break;
-            }else if (move == "UP" && i > 0){
-              char temp = board[i - 1][j];
-              board[i][j] = temp;
-              board[i - 1][j] = '#';
-              break;
-            }else if (move == "RIGHT" && j < 3){
-              char temp = board[i][j + 1];
-              board[i][j] = temp;
-              board[i][j + 1] = '#';
-              break;
-            }else if (move == "LEFT" && j > 0){
-              char temp = board[i][j - 1];
-              board[i][j] = temp;
-              board[i][j - 1] = '#';
-              break;
+      const SuccessorTable& moves = SuccessorTable::square(4);
+      int blankPos = -1;
+      for (int cell = 0; cell < 16; cell++){
+            if (board[cell / 4][cell % 4] == '#') blankPos = cell;
+      }
+      int index = -1;
+      for (int m = MOVE_UP; m <= MOVE_RIGHT; m++){
+            if (move == SuccessorTable::moveName(m)) index = m;
+      }
+      if (blankPos >= 0 && index >= 0){
+            int target = moves.target(blankPos, index);
+            if (target >= 0){
+                  board[blankPos / 4][blankPos % 4] = board[target / 4][target % 4];
+                  board[target / 4][target % 4] = '#';
             }
-          }
-        }
       }
       print_board(board);
 }
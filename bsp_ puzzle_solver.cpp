@@ -6,7 +6,8 @@
  * of moves required to reach the goal state from the initial state.
  * 
  * Goal state: "ABCDEFGHIJKLMNO#"
- * Where '#' represents the empty space.
+ * Where '#' represents the empty space. A custom goal can be given as a
+ * second input token: any board with the same tiles (see goal_relabel.h).
  * 
  * @author JAPeTo
  * @version 1.6
@@ -15,6 +16,9 @@
 #include <iostream>
 #include <queue>
 #include <unordered_set>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "goal_relabel.h"
 
 using namespace std;
 
@@ -23,16 +27,18 @@ using namespace std;
  * 
  * Up, Down, Left, Right
  */
-const int dRow[] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
-const int dCol[] = {0, 0, -1, 1};
 const string MOVES[] = {"UP", "DOWN", "LEFT", "RIGHT"};
+const string TARGET = "ABCDEFGHIJKLMNO#";
+string goalBoard = TARGET;  // TARGET or the custom goal of the input
 
 struct State{
       string board;
       int blankPos;
       int cost;
+      int pruneState; // Move-pruning automaton state (see move_pruning_table.h)
       // Constructor
-      State(string b, int pos, int c) : board(b), blankPos(pos), cost(c) {}
+      State(string b, int pos, int c, int ps = MOVE_PRUNING_START)
+            : board(b), blankPos(pos), cost(c), pruneState(ps) {}
 };
 
 // =============================================================================
@@ -56,7 +62,6 @@ string swapBoardTiles(const string &currentBoard, int position1, int position2){
  * will be found first due to BFS properties.
  */
 int bfs(string start){
-      const string TARGET = "ABCDEFGHIJKLMNO#";
       queue<State> q;
       unordered_set<string> visited;
 
@@ -70,28 +75,22 @@ int bfs(string start){
             q.pop();
             
             // Check if goal state is reached
-            if (current.board == TARGET) return current.cost;
+            if (current.board == goalBoard) return current.cost;
 
-            // Convert 1D position to 2D coordinates
-            int row = current.blankPos / 4;
-            int col = current.blankPos % 4;
+            // Legal moves of the blank, precomputed per cell (successor_table.h)
+            const SuccessorTable& moves = SuccessorTable::square(4);
+            for (int k = 0; k < moves.count(current.blankPos); k++){
+                  int i = moves.move(current.blankPos, k);
+                  // The inverse move would only find the parent in visited; the automaton drops it without the hash probe
+                  int nextPruneState = MOVE_PRUNING_NEXT[current.pruneState][i];
+                  if (nextPruneState < 0) continue;
+                  int newPos = moves.neighbor(current.blankPos, k);
+                  string newBoard = swapBoardTiles(current.board, current.blankPos, newPos);
 
-            // Try all 4 possible moves
-            for (int i = 0; i < 4; i++){
-                  int newRow = row + dRow[i];
-                  int newCol = col + dCol[i];
-
-                  // Check if the move is within bounds
-                  if (newRow >= 0 && newRow < 4 && newCol >= 0 && newCol < 4){
-                        // Convert 2D coordinates back to 1D position
-                        int newPos = newRow * 4 + newCol;
-                        string newBoard = swapBoardTiles(current.board, current.blankPos, newPos);
-
-                        // If this state hasn't been visited, add it to the queue
-                        if (visited.find(newBoard) == visited.end()){
-                              q.push(State(newBoard, newPos, current.cost + 1));
-                              visited.insert(newBoard);
-                        }
+                  // If this state hasn't been visited, add it to the queue
+                  if (visited.find(newBoard) == visited.end()){
+                        q.push(State(newBoard, newPos, current.cost + 1, nextPruneState));
+                        visited.insert(newBoard);
                   }
             }
       }
@@ -104,8 +103,22 @@ int bfs(string start){
 // =============================================================================
 
 int main(){
-      string start;
+      string start, goal;
       cin >> start;
+
+      // Optional custom goal: searched for directly, the blank may be anywhere
+      if (cin >> goal) {
+            if (!sameTiles(start, goal, TARGET)) {
+                  cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                  return 1;
+            }
+            if (!goalReachable(start, goal, 4)) {
+                  cout << -1 << endl;
+                  return 0;
+            }
+            goalBoard = goal;
+      }
+
       int result = bfs(start);
       cout << result << endl;
       return 0;
@@ -10,7 +10,19 @@
  * 
  * Usage:
  *   bsp_puzzle_solver_nxn <N> <initial_state>
+ *   Optional third argument (or second stdin token): custom goal board, any
+ *   board with the tiles of the generated target (see goal_relabel.h)
  *   Example: bsp_puzzle_solver_nxn 4 ABCDEFG#IJKHMNOL
+ *
+ *   Options (either mode):
+ *   --bloom-mb MB  Bounded-memory mode: older layers are kept in a Bloom filter
+ *                  (bloom_filter.h) and only the layer being built is stored
+ *                  exactly; false positives may lose states
+ *   --verify       Also keep the exact visited set and count false positives
+ *   --stats        Print the size of every layer to stderr
+ *   --frontier     Frontier search (frontier_search.h): only the open layers
+ *                  are kept and the path is rebuilt by divide and conquer;
+ *                  the blank moves are printed too
  * 
  * @author JAPeTo
  * @version 2.0 - Generic NxN support (Tarea No. 7)
@@ -22,6 +34,14 @@
 #include <string>
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "goal_relabel.h"
+#include "bloom_filter.h"
+#include "frontier_search.h"
 
 using namespace std;
 using namespace chrono;
@@ -33,8 +53,11 @@ using namespace chrono;
 int N = 4;  // Board size (NxN)
 string TARGET;  // Goal state (generated dynamically)
 
-const int dRow[] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
-const int dCol[] = {0, 0, -1, 1};
+
+BlockedBloomFilter* bloom = nullptr;  // Bounded-memory mode when not null
+bool verifyBloom = false;
+bool printStats = false;
+bool frontierMode = false;  // Frontier search instead of the visited set
 
 // =============================================================================
 // STATE STRUCTURE
@@ -44,8 +67,10 @@ struct State {
       string board;
       int blankPos;
       int cost;
+      int pruneState; // Move-pruning automaton state (see move_pruning_table.h)
       
-      State(string b, int pos, int c) : board(b), blankPos(pos), cost(c) {}
+      State(string b, int pos, int c, int ps = MOVE_PRUNING_START)
+            : board(b), blankPos(pos), cost(c), pruneState(ps) {}
 };
 
 // =============================================================================
@@ -101,36 +126,6 @@ string swapTiles(const string& board, int pos1, int pos2) {
       return newBoard;
 }
 
-/**
- * @brief Validates if the puzzle is solvable
- * @param board Initial board state
- * @return true if solvable, false otherwise
- */
-bool isSolvable(const string& board) {
-      // Count inversions
-      int inversions = 0;
-      int size = N * N;
-      
-      for (int i = 0; i < size - 1; i++) {
-            if (board[i] == '#') continue;
-            for (int j = i + 1; j < size; j++) {
-                  if (board[j] == '#') continue;
-                  if (board[i] > board[j]) inversions++;
-            }
-      }
-      
-      // For odd N: solvable if inversions is even
-      // For even N: solvable if (inversions + blank row from bottom) is odd
-      if (N % 2 == 1) {
-            return inversions % 2 == 0;
-      } else {
-            int blankPos = board.find('#');
-            int blankRow = blankPos / N;
-            int blankRowFromBottom = N - blankRow;
-            return (inversions + blankRowFromBottom) % 2 == 1;
-      }
-}
-
 // =============================================================================
 // BFS ALGORITHM
 // =============================================================================
@@ -142,44 +137,83 @@ bool isSolvable(const string& board) {
  */
 int bfs(string start) {
       queue<State> q;
-      unordered_set<string> visited;
+      unordered_set<string> visited;     // exact mode: every state seen
+      unordered_set<string> levelSet;    // bloom mode: layer being built
+      unordered_set<string> olderExact;  // bloom + verify: every older layer
+      hash<string> hashBoard;
       
       int blankPos = start.find('#');
       q.push(State(start, blankPos, 0));
-      visited.insert(start);
+      if (bloom) {
+            bloom->insert(hashBoard(start));
+            if (verifyBloom) olderExact.insert(start);
+      } else {
+            visited.insert(start);
+      }
       
       int nodesExpanded = 0;
+      int depth = 0;
+      long long rejected = 0, falsePositives = 0;
       
       while (!q.empty()) {
             State current = q.front();
             q.pop();
             
+            // The queue reached the next layer: the finished one becomes an older layer
+            if (current.cost > depth) {
+                  depth = current.cost;
+                  if (printStats) cerr << "Layer " << depth << ": " << q.size() + 1 << " states" << endl;
+                  if (bloom) {
+                        for (const string& board : levelSet) {
+                              bloom->insert(hashBoard(board));
+                              if (verifyBloom) olderExact.insert(board);
+                        }
+                        levelSet.clear();
+                  }
+            }
+            
             nodesExpanded++;
             
             // Check if goal state is reached
             if (current.board == TARGET) {
                   //cerr << "Nodes expanded: " << nodesExpanded << endl;
+                  if (printStats && bloom) {
+                        cerr << "Bloom filter: " << bloom->bytes() / (1024 * 1024) << " MB, "
+                             << bloom->size() << " keys, estimated false-positive rate: "
+                             << bloom->estimatedFalsePositiveRate() << endl;
+                        cerr << "Rejected as seen: " << rejected;
+                        if (verifyBloom) cerr << ", false positives: " << falsePositives;
+                        cerr << endl;
+                  }
                   return current.cost;
             }
             
-            // Convert 1D position to 2D coordinates (GENERIC)
-            int row = current.blankPos / N;
-            int col = current.blankPos % N;
-            
-            // Try all 4 possible moves
-            for (int i = 0; i < 4; i++) {
-                  int newRow = row + dRow[i];
-                  int newCol = col + dCol[i];
+            // Legal moves of the blank, precomputed per cell (successor_table.h)
+            const SuccessorTable& moves = SuccessorTable::square(N);
+            for (int k = 0; k < moves.count(current.blankPos); k++) {
+                  int i = moves.move(current.blankPos, k);
+                  // Inverse moves are dropped before the visited insert or Bloom probe they would cost
+                  int nextPruneState = MOVE_PRUNING_NEXT[current.pruneState][i];
+                  if (nextPruneState < 0) continue;
+                  int newPos = moves.neighbor(current.blankPos, k);
+                  string newBoard = swapTiles(current.board, current.blankPos, newPos);
                   
-                  // Validate bounds (GENERIC)
-                  if (newRow >= 0 && newRow < N && newCol >= 0 && newCol < N) {
-                        int newPos = newRow * N + newCol;
-                        string newBoard = swapTiles(current.board, current.blankPos, newPos);
-                        
-                        if (visited.find(newBoard) == visited.end()) {
-                              visited.insert(newBoard);
-                              q.push(State(newBoard, newPos, current.cost + 1));
+                  bool isNew;
+                  if (!bloom) {
+                        isNew = visited.insert(newBoard).second;
+                  } else {
+                        // Approximate check against older layers, exact against this one
+                        isNew = true;
+                        if (bloom->mayContain(hashBoard(newBoard))) {
+                              isNew = verifyBloom && olderExact.find(newBoard) == olderExact.end();
+                              if (isNew) falsePositives++;
+                              rejected++;
                         }
+                        if (isNew) isNew = levelSet.insert(newBoard).second;
+                  }
+                  
+                  if (isNew) {
+                        q.push(State(newBoard, newPos, current.cost + 1, nextPruneState));
                   }
             }
       }
@@ -187,14 +221,79 @@ int bfs(string start) {
       return -1; // No solution found
 }
 
+// =============================================================================
+// FRONTIER SEARCH
+// =============================================================================
+
+/**
+ * @brief NxN string boards for FrontierSearch
+ */
+struct StringSpace {
+      typedef string State;
+      
+      int side() const { return N; }
+      int blank(const string& board) const { return board.find('#'); }
+      int tile(const string& board, int cell) const { return (unsigned char)board[cell]; }
+      string slide(const string& board, int blank, int target) const { return swapTiles(board, blank, target); }
+};
+
+/**
+ * @brief Frontier search from start to goal; memory is two layers, not the
+ *        whole explored space
+ * @param path Output: the blank moves as "UDLR" letters
+ * @return Minimum number of moves, or -1 if the goal is unreachable
+ */
+int frontierBFS(const string& start, const string& goal, string& path) {
+      StringSpace space;
+      FrontierSearch<StringSpace> search(space, 1);
+      if (printStats) {
+            search.setLayerCallback([](int depth, size_t states) {
+                  cerr << "Layer " << depth << ": " << states << " states" << endl;
+            });
+      }
+      int solution = search.solve(start, goal, path);
+      if (printStats) {
+            cerr << "Frontier search: " << search.searchNodes() << " nodes expanded, " << search.pathNodes()
+                 << " more in " << search.searches() - 1 << " searches to rebuild the path, peak "
+                 << search.peakStates() << " states stored" << endl;
+      }
+      return solution;
+}
+
 // =============================================================================
 // MAIN FUNCTION
 // =============================================================================
 
 int main(int argc, char* argv[]) {
+      // Options may appear anywhere; the remaining arguments are positional
+      vector<char*> positional;
+      size_t bloomMB = 0;
+      positional.push_back(argv[0]);
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--bloom-mb") == 0 && i + 1 < argc) {
+                  bloomMB = atol(argv[++i]);
+            } else if (strcmp(argv[i], "--verify") == 0) {
+                  verifyBloom = true;
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            } else if (strcmp(argv[i], "--frontier") == 0) {
+                  frontierMode = true;
+            } else {
+                  positional.push_back(argv[i]);
+            }
+      }
+      argc = positional.size();
+      argv = positional.data();
+      
+      if (frontierMode && bloomMB > 0) {
+            cerr << "Error: --frontier keeps no visited set (no --bloom-mb)" << endl;
+            return 1;
+      }
+      if (bloomMB > 0) bloom = new BlockedBloomFilter(bloomMB * 1024 * 1024);
+      
       if (argc < 2) {
             // Default mode: read from stdin for compatibility
-            string puzzle;
+            string puzzle, goal;
             cin >> puzzle;
             
             // Auto-detect board size
@@ -209,17 +308,32 @@ int main(int argc, char* argv[]) {
             
             TARGET = generateTarget(N, false);
             
+            // Optional custom goal: searched for directly, the blank may be anywhere
+            if (cin >> goal) {
+                  if (!sameTiles(puzzle, goal, TARGET)) {
+                        cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                        return 1;
+                  }
+                  if (!goalReachable(puzzle, goal, N)) {
+                        cout << -1 << endl;
+                        return 0;
+                  }
+                  TARGET = goal;
+            }
+            
             auto startTime = high_resolution_clock::now();
-            int solution = bfs(puzzle);
+            string path;
+            int solution = frontierMode ? frontierBFS(puzzle, TARGET, path) : bfs(puzzle);
             auto endTime = high_resolution_clock::now();
             
             double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
             
+            if (frontierMode && solution >= 0) cout << (path.empty() ? "-" : path) << endl;
             cout << solution << endl;
             //cerr << "Time: " << timeMs << " ms" << endl;
             
-      } else if (argc == 3) {
-            // New mode: specify board size
+      } else if (argc == 3 || argc == 4) {
+            // New mode: specify board size (and optionally a custom goal)
             N = atoi(argv[1]);
             string puzzle = argv[2];
             
@@ -235,6 +349,14 @@ int main(int argc, char* argv[]) {
             
             TARGET = generateTarget(N, false);
             
+            if (argc == 4) {
+                  if (!sameTiles(puzzle, argv[3], TARGET)) {
+                        cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                        return 1;
+                  }
+                  TARGET = argv[3];
+            }
+            
             cout << "========================================" << endl;
             cout << "BFS Solver - " << N << "x" << N << " Puzzle" << endl;
             cout << "========================================" << endl;
@@ -242,23 +364,26 @@ int main(int argc, char* argv[]) {
             cout << "Target:  " << TARGET << endl;
             cout << "----------------------------------------" << endl;
             
-            if (!isSolvable(puzzle)) {
+            if (!goalReachable(puzzle, TARGET, N)) {
                   cout << "This puzzle is NOT SOLVABLE" << endl;
                   return 1;
             }
             
             auto startTime = high_resolution_clock::now();
-            int solution = bfs(puzzle);
+            string path;
+            int solution = frontierMode ? frontierBFS(puzzle, TARGET, path) : bfs(puzzle);
             auto endTime = high_resolution_clock::now();
             
             double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
             
             cout << "Solution: " << solution << " moves" << endl;
+            if (frontierMode && solution >= 0) cout << "Path: " << (path.empty() ? "-" : path) << endl;
             cout << "Time: " << timeMs << " ms" << endl;
             cout << "========================================" << endl;
             
       } else {
-            cerr << "Usage: " << argv[0] << " [board_size] <puzzle>" << endl;
+            cerr << "Usage: " << argv[0] << " [board_size] <puzzle> [goal] [--bloom-mb MB] [--verify] [--stats]"
+                 << " [--frontier]" << endl;
             cerr << "  Mode 1 (auto-detect): echo \"ABCDEFG#IJKHMNOL\" | " << argv[0] << endl;
             cerr << "  Mode 2 (specify size): " << argv[0] << " 4 ABCDEFG#IJKHMNOL" << endl;
             cerr << endl;
@@ -269,5 +394,6 @@ int main(int argc, char* argv[]) {
             return 1;
       }
       
+      delete bloom;
       return 0;
 }
@@ -0,0 +1,298 @@
+/**
+ * @file build_distance_table.cpp
+ * @brief Builds exact distance tables with the parallel retrograde builder
+ *
+ * Two state spaces are provided for retrograde_builder.h:
+ *
+ *   full     Every board of a 2x2 or 3x3 puzzle, ranked by its permutation
+ *            ((n*n)! ranks; half of them are unreachable and stay UNSEEN).
+ *   pattern  A 4x4 pattern: the blank plus a subset of the tiles, the other
+ *            tiles being indistinguishable. Every blank move costs 1, so the
+ *            table is an admissible heuristic for the 15-puzzle (combine
+ *            several with max, they are not additive).
+ *
+ * The table is written as one byte per rank (255 = unreachable); the
+ * distance histogram is printed to stdout and the per-level progress
+ * (states found, time, table scan throughput) to stderr.
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -fopenmp -o build_distance_table build_distance_table.cpp
+ *
+ * Usage:
+ *   build_distance_table [--space full|pattern] [--size N] [--tiles LETTERS]
+ *                        [--threads T] [--checkpoint FILE] [--output FILE]
+ *
+ *   --space       full (default) or pattern
+ *   --size N      Board size of the full space, 2 or 3 (default 3)
+ *   --tiles       Pattern tiles of the 4x4 goal (default ABCDE)
+ *   --threads T   Worker threads (default: all cores)
+ *   --checkpoint  Save the table after every level; resume from it if present
+ *   --output      Write the finished table to this file
+ *
+ * Example:
+ *   build_distance_table --space pattern --tiles ABCDEF --checkpoint abcdef.ckpt --output abcdef.pdb
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <omp.h>
+#include "retrograde_builder.h"
+#include "successor_table.h"
+
+using namespace std;
+
+
+// =============================================================================
+// STATE SPACES
+// =============================================================================
+
+/**
+ * @brief All boards of an NxN puzzle ("ABC...#"), ranked lexicographically
+ */
+class FullPuzzleSpace {
+public:
+      typedef string State;
+
+      explicit FullPuzzleSpace(int size) : n(size), cells(size * size), ranks(1) {
+            for (int i = 2; i <= cells; i++) ranks *= i;
+      }
+
+      uint64_t size() const { return ranks; }
+
+      State goal() const {
+            string board;
+            for (int i = 0; i < cells - 1; i++) board += (char)('A' + i);
+            return board + '#';
+      }
+
+      uint64_t rank(const State& board) const {
+            uint64_t result = 0;
+            unsigned unused = (1u << cells) - 1;
+            for (int pos = 0; pos < cells; pos++) {
+                  int tile = tileIndex(board[pos]);
+                  result = result * (cells - pos) + __builtin_popcount(unused & ((1u << tile) - 1));
+                  unused &= ~(1u << tile);
+            }
+            return result;
+      }
+
+      State unrank(uint64_t rank) const {
+            int digits[16];
+            for (int pos = cells - 1; pos >= 0; pos--) {
+                  digits[pos] = rank % (cells - pos);
+                  rank /= (cells - pos);
+            }
+            string board(cells, '#');
+            unsigned unused = (1u << cells) - 1;
+            for (int pos = 0; pos < cells; pos++) {
+                  unsigned bits = unused;
+                  for (int skip = 0; skip < digits[pos]; skip++) bits &= bits - 1;
+                  int tile = __builtin_ctz(bits);
+                  unused &= ~(1u << tile);
+                  board[pos] = tile == cells - 1 ? '#' : (char)('A' + tile);
+            }
+            return board;
+      }
+
+      void neighbors(const State& board, vector<State>& out) const {
+            int blank = board.find('#');
+            const SuccessorTable& moves = SuccessorTable::square(n);
+            for (int k = 0; k < moves.count(blank); k++) {
+                  out.push_back(board);
+                  swap(out.back()[blank], out.back()[moves.neighbor(blank, k)]);
+            }
+      }
+
+private:
+      // '#' sorts after every tile
+      int tileIndex(char c) const { return c == '#' ? cells - 1 : c - 'A'; }
+
+      int n;
+      int cells;
+      uint64_t ranks;
+};
+
+/**
+ * @brief 4x4 pattern: cells of the blank and of k tiles (other tiles unlabelled)
+ */
+class PatternSpace {
+public:
+      static const int MAX_TILES = 7;
+
+      struct State {
+            uint8_t pos[MAX_TILES + 1];  // pos[0] = blank, pos[1..k] = pattern tiles
+      };
+
+      explicit PatternSpace(const string& patternTiles) : tiles(patternTiles), k(patternTiles.size()), ranks(1) {
+            for (int i = 0; i <= k; i++) ranks *= 16 - i;
+      }
+
+      uint64_t size() const { return ranks; }
+
+      State goal() const {
+            State s;
+            s.pos[0] = 15;
+            for (int i = 0; i < k; i++) s.pos[i + 1] = tiles[i] - 'A';
+            return s;
+      }
+
+      uint64_t rank(const State& s) const {
+            uint64_t result = 0;
+            unsigned unused = 0xFFFF;
+            for (int i = 0; i <= k; i++) {
+                  result = result * (16 - i) + __builtin_popcount(unused & ((1u << s.pos[i]) - 1));
+                  unused &= ~(1u << s.pos[i]);
+            }
+            return result;
+      }
+
+      State unrank(uint64_t rank) const {
+            int digits[MAX_TILES + 1];
+            for (int i = k; i >= 0; i--) {
+                  digits[i] = rank % (16 - i);
+                  rank /= (16 - i);
+            }
+            State s;
+            unsigned unused = 0xFFFF;
+            for (int i = 0; i <= k; i++) {
+                  unsigned bits = unused;
+                  for (int skip = 0; skip < digits[i]; skip++) bits &= bits - 1;
+                  s.pos[i] = __builtin_ctz(bits);
+                  unused &= ~(1u << s.pos[i]);
+            }
+            return s;
+      }
+
+      void neighbors(const State& s, vector<State>& out) const {
+            int blank = s.pos[0];
+            const SuccessorTable& moves = SuccessorTable::square(4);
+            for (int m = 0; m < moves.count(blank); m++) {
+                  int cell = moves.neighbor(blank, m);
+                  State next = s;
+                  next.pos[0] = cell;
+                  for (int i = 1; i <= k; i++) {
+                        if (next.pos[i] == cell) next.pos[i] = blank;  // pattern tile slides
+                  }
+                  out.push_back(next);
+            }
+      }
+
+private:
+      string tiles;
+      int k;
+      uint64_t ranks;
+};
+
+// =============================================================================
+// BUILD DRIVER
+// =============================================================================
+
+void printProgress(const RetrogradeProgress& p) {
+      cerr << "level " << setw(3) << p.level << ": " << setw(12) << p.newStates << " new, "
+           << setw(12) << p.totalStates << " total";
+      if (p.resumed) {
+            cerr << " (from checkpoint)" << endl;
+            return;
+      }
+      double rate = p.levelSeconds > 0 ? p.scannedRanks / p.levelSeconds : 0;
+      cerr << fixed << setprecision(3) << ", " << p.levelSeconds << " s, "
+           << setprecision(1) << rate / 1e6 << " M ranks/s, " << p.totalSeconds << " s elapsed" << endl;
+      cerr.unsetf(ios::fixed);
+}
+
+template <class Space>
+int buildTable(const Space& space, int numThreads, const string& checkpoint, const string& output) {
+      cerr << "Ranks: " << space.size() << " (" << space.size() / (1 << 20) << " MB table), threads: "
+           << numThreads << endl;
+
+      RetrogradeBuilder<Space> builder(space, numThreads);
+      builder.setProgressCallback(printProgress);
+      if (!checkpoint.empty()) builder.setCheckpoint(checkpoint);
+
+      vector<typename Space::State> goals(1, space.goal());
+      if (!builder.build(goals)) {
+            cerr << "Error: build failed" << endl;
+            return 1;
+      }
+
+      const vector<uint64_t>& histogram = builder.histogram();
+      for (size_t level = 0; level < histogram.size(); level++) {
+            cout << level << " " << histogram[level] << endl;
+      }
+      cout << "States: " << builder.reachedStates() << endl;
+      cout << "Max distance: " << builder.maxLevel() << endl;
+
+      if (!output.empty() && !builder.save(output)) {
+            cerr << "Error: cannot write " << output << endl;
+            return 1;
+      }
+      return 0;
+}
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+int main(int argc, char* argv[]) {
+      string spaceName = "full";
+      int size = 3;
+      string tiles = "ABCDE";
+      int numThreads = omp_get_max_threads();
+      string checkpoint, output;
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--space") == 0 && i + 1 < argc) {
+                  spaceName = argv[++i];
+            } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+                  size = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--tiles") == 0 && i + 1 < argc) {
+                  tiles = argv[++i];
+            } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                  numThreads = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+                  checkpoint = argv[++i];
+            } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+                  output = argv[++i];
+            } else {
+                  cerr << "Usage: " << argv[0] << " [--space full|pattern] [--size N] [--tiles LETTERS]"
+                       << " [--threads T] [--checkpoint FILE] [--output FILE]" << endl;
+                  return 1;
+            }
+      }
+      if (numThreads < 1) numThreads = 1;
+
+      if (spaceName == "full") {
+            if (size < 2 || size > 3) {
+                  cerr << "Error: the full space is only tabulated for 2x2 and 3x3" << endl;
+                  return 1;
+            }
+            return buildTable(FullPuzzleSpace(size), numThreads, checkpoint, output);
+      }
+
+      if (spaceName == "pattern") {
+            unsigned seen = 0;
+            bool valid = !tiles.empty() && (int)tiles.size() <= PatternSpace::MAX_TILES;
+            for (size_t i = 0; valid && i < tiles.size(); i++) {
+                  int tile = tiles[i] - 'A';
+                  valid = tile >= 0 && tile < 15 && !(seen & (1u << tile));
+                  seen |= 1u << tile;
+            }
+            if (!valid) {
+                  cerr << "Error: --tiles must be 1 to " << PatternSpace::MAX_TILES
+                       << " distinct letters A-O" << endl;
+                  return 1;
+            }
+            return buildTable(PatternSpace(tiles), numThreads, checkpoint, output);
+      }
+
+      cerr << "Error: unknown space " << spaceName << endl;
+      return 1;
+}
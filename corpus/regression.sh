@@ -0,0 +1,82 @@
+#!/bin/bash
+# Regression run over the corpora of this directory: every solver must print
+# the recorded optimal depth of every board.
+#
+#   corpus/regression.sh [solver ...]      (default: all solvers below)
+#
+# Binaries are built with g++ into $BUILD (default /tmp/puzzle_regression).
+# Corpora: walk_3x3_seed1.txt, walk_4x4_seed1.txt and the boards converted by
+# "instance_generator korf100" from korf100_format_sample.txt. A solver only
+# gets the boards of its sizes and up to its depth limit (BFS keeps every
+# visited board, so it stops at depth 20).
+#
+# Exit status: 0 when every answer matches, 1 otherwise.
+
+cd "$(dirname "$0")/.." || exit 1
+BUILD=${BUILD:-/tmp/puzzle_regression}
+mkdir -p "$BUILD"
+
+# name | source | build flags | board sizes | max depth
+SOLVERS="
+h2_puzzle_solver|h2_ puzzle_solver.cpp||16|30
+h2_puzzle_solver_nxn|h2_puzzle_solver_nxn.cpp||9 16|30
+bsp_puzzle_solver_nxn|bsp_puzzle_solver_nxn.cpp||9 16|20
+parallel_idastar_h2_openmp|parallel_idastar_h2_openmp.cpp|-fopenmp|16|30
+parallel_astar_h2_openmp|parallel_astar_h2_openmp.cpp|-fopenmp|16|26
+puzzle_solver_cli|puzzle_solver_cli.cpp|-pthread|9 16|30
+portfolio_solver|portfolio_solver.cpp|-pthread|16|30
+"
+
+build() {
+      if ! g++ -std=c++11 -O2 $3 -o "$BUILD/$1" "$2" 2> "$BUILD/$1.log"; then
+            echo "BUILD FAILED $2 (see $BUILD/$1.log)"
+            return 1
+      fi
+}
+
+build instance_generator instance_generator.cpp || exit 1
+"$BUILD/instance_generator" korf100 corpus/korf100_format_sample.txt > "$BUILD/korf_sample.txt" 2> /dev/null
+cat corpus/walk_3x3_seed1.txt corpus/walk_4x4_seed1.txt "$BUILD/korf_sample.txt" > "$BUILD/all.txt"
+
+failures=0
+while IFS='|' read -r name source flags sizes maxDepth; do
+      [ -z "$name" ] && continue
+      if [ $# -gt 0 ] && [[ " $* " != *" $name "* ]]; then continue; fi
+      build "$name" "$source" "$flags" || { failures=$((failures + 1)); continue; }
+
+      checked=0
+      start=$(date +%s)
+      while read -r board depth; do
+            [[ " $sizes " == *" ${#board} "* ]] || continue
+            [ "$depth" -le "$maxDepth" ] || continue
+            answer=$(echo "$board" | timeout 120 "$BUILD/$name" 2> /dev/null | tail -1)
+            if [ "$answer" != "$depth" ]; then
+                  echo "MISMATCH $name $board: got '$answer', expected $depth"
+                  failures=$((failures + 1))
+            fi
+            checked=$((checked + 1))
+      done < "$BUILD/all.txt"
+      echo "$name: $checked boards, $(( $(date +%s) - start )) s"
+done <<< "$SOLVERS"
+
+# The batch scheduler checks the corpus depths itself
+if [ $# -eq 0 ] || [[ " $* " == *" batch_scheduler "* ]]; then
+      if build batch_scheduler batch_scheduler.cpp -pthread; then
+            for corpus in corpus/walk_3x3_seed1.txt corpus/walk_4x4_seed1.txt "$BUILD/korf_sample.txt"; do
+                  if ! "$BUILD/batch_scheduler" < "$corpus" > /dev/null 2> "$BUILD/batch.log"; then
+                        echo "MISMATCH batch_scheduler on $corpus:"
+                        cat "$BUILD/batch.log"
+                        failures=$((failures + 1))
+                  fi
+            done
+            echo "batch_scheduler: 3 corpora"
+      else
+            failures=$((failures + 1))
+      fi
+fi
+
+if [ $failures -gt 0 ]; then
+      echo "Regression FAILED: $failures"
+      exit 1
+fi
+echo "Regression passed"
@@ -0,0 +1,894 @@
+/**
+ * @file distributed_search.cpp
+ * @brief Multi-process BFS and A* (h2) with hash-partitioned states
+ *
+ * Every state is owned by one worker process, chosen by a hash of its packed
+ * board. A worker only expands the states it owns; successors are buffered
+ * per destination and sent in batches to their owners, which do the
+ * duplicate detection. Workers never share memory except through the
+ * transport, so the same code can later run on several machines.
+ *
+ * Search proceeds in synchronized rounds:
+ *   - BFS: one round per layer.
+ *   - A*: one round per f-value (repeated while new states with that f
+ *     arrive); with a consistent heuristic a goal expanded in the round of
+ *     value f is optimal because every lower f is exhausted on every worker.
+ *
+ * Termination detection: at the end of its expansion phase a worker sends a
+ * DONE marker to every worker. Channels are FIFO, so once a worker has every
+ * DONE marker it has received every batch of that round. Workers then
+ * exchange a STATUS message (frontier size, lowest f, goal found, nodes
+ * expanded) all-to-all, so every worker computes the same global decision
+ * (stop, next layer or next f) without a coordinator.
+ *
+ * Transports (pluggable through the Transport class):
+ *   shm  Single-producer/single-consumer ring buffers, one per ordered pair
+ *        of workers, in a shared anonymous mapping created before fork().
+ *   tcp  One TCP connection per pair of workers on localhost
+ *        (worker r listens on port + r).
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -o distributed_search distributed_search.cpp
+ *
+ * Usage:
+ *   distributed_search [--workers N] [--algo bfs|astar] [--transport shm|tcp]
+ *                      [--port P] [--stats] < "puzzle [goal]"
+ *
+ *   The goal may be any board with the same tiles (goal_relabel.h); the
+ *   Manhattan table is built from its cells before the workers are forked.
+ *
+ * Example:
+ *   echo "EABCM#GDKFILNOJH" | ./distributed_search --workers 4 --algo astar --transport tcp
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <sched.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "packed_board.h"
+#include "goal_relabel.h"
+#include "successor_table.h"
+
+using namespace std;
+using namespace chrono;
+
+const string TARGET = "ABCDEFGHIJKLMNO#";
+string goalBoard = TARGET;  // TARGET or the custom goal of the input
+
+const uint64_t NONE = UINT64_MAX;  // "no value" in status messages
+
+// =============================================================================
+// MESSAGES
+// =============================================================================
+
+enum MessageType {
+      MESSAGE_BATCH = 1,   // [type, entries...] successors for the receiving owner
+      MESSAGE_DONE = 2,    // [type] sender finished the expansion phase of this round
+      MESSAGE_STATUS = 3   // [type, size, minF, found, expanded] sender's round summary
+};
+
+const int BATCH_WORDS = 4096;  // Flush a destination buffer at this many words
+
+/**
+ * @brief Round summary exchanged by all workers
+ */
+struct Status {
+      uint64_t size;      // Summed: states waiting for the next round
+      uint64_t minF;      // Minimum: lowest f in the open list (A*)
+      uint64_t found;     // Minimum: cost of a goal expanded this round
+      uint64_t expanded;  // Summed: nodes expanded so far
+
+      Status() : size(0), minF(NONE), found(NONE), expanded(0) {}
+};
+
+// =============================================================================
+// TRANSPORT
+// =============================================================================
+
+/**
+ * @brief Ordered, reliable message channels between all pairs of workers
+ *
+ * Implementations only move words between processes; messages a worker
+ * sends to itself never touch the backend. Sending never deadlocks: while
+ * a channel is full the backend keeps draining incoming channels.
+ */
+class Transport {
+public:
+      Transport(int r, int n) : rank(r), numWorkers(n) {}
+      virtual ~Transport() {}
+
+      void send(int dest, const vector<uint64_t>& message) {
+            if (dest == rank) {
+                  pending.push_back(message);
+                  return;
+            }
+            sendRemote(dest, message);
+      }
+
+      /**
+       * @brief Takes the next message if one is available
+       */
+      bool tryReceive(vector<uint64_t>& message) {
+            if (pending.empty()) poll();
+            if (pending.empty()) return false;
+            message.swap(pending.front());
+            pending.pop_front();
+            return true;
+      }
+
+      /**
+       * @brief Waits for the next message
+       */
+      void receive(vector<uint64_t>& message) {
+            while (!tryReceive(message)) waitForData();
+      }
+
+protected:
+      virtual void sendRemote(int dest, const vector<uint64_t>& message) = 0;
+
+      // Moves every complete incoming message to pending
+      virtual void poll() = 0;
+
+      virtual void waitForData() { sched_yield(); }
+
+      int rank;
+      int numWorkers;
+      deque<vector<uint64_t> > pending;
+};
+
+/**
+ * @brief Shared-memory backend: one ring buffer per ordered pair of workers
+ */
+class ShmTransport : public Transport {
+public:
+      static const uint64_t RING_WORDS = 1 << 16;
+
+      struct Ring {
+            uint64_t head;  // Next word to read (written by the consumer)
+            char padding1[56];
+            uint64_t tail;  // Next word to write (written by the producer)
+            char padding2[56];
+            uint64_t words[RING_WORDS];
+      };
+
+      /**
+       * @brief Maps the rings for all workers; must be called before fork()
+       */
+      static void* createRegion(int numWorkers) {
+            size_t bytes = sizeof(Ring) * numWorkers * numWorkers;
+            void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+            return region == MAP_FAILED ? nullptr : region;
+      }
+
+      ShmTransport(int r, int n, void* region) : Transport(r, n), rings((Ring*)region) {}
+
+protected:
+      Ring* ring(int source, int dest) { return &rings[source * numWorkers + dest]; }
+
+      void sendRemote(int dest, const vector<uint64_t>& message) {
+            Ring* r = ring(rank, dest);
+            uint64_t needed = message.size() + 1;
+            uint64_t tail = r->tail;
+            while (RING_WORDS - (tail - __atomic_load_n(&r->head, __ATOMIC_ACQUIRE)) < needed) {
+                  poll();
+                  sched_yield();
+            }
+            r->words[tail % RING_WORDS] = message.size();
+            for (size_t i = 0; i < message.size(); i++) {
+                  r->words[(tail + 1 + i) % RING_WORDS] = message[i];
+            }
+            __atomic_store_n(&r->tail, tail + needed, __ATOMIC_RELEASE);
+      }
+
+      void poll() {
+            for (int source = 0; source < numWorkers; source++) {
+                  if (source == rank) continue;
+                  Ring* r = ring(source, rank);
+                  uint64_t head = r->head;
+                  uint64_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+                  while (head < tail) {
+                        uint64_t length = r->words[head % RING_WORDS];
+                        vector<uint64_t> message(length);
+                        for (uint64_t i = 0; i < length; i++) {
+                              message[i] = r->words[(head + 1 + i) % RING_WORDS];
+                        }
+                        pending.push_back(message);
+                        head += length + 1;
+                  }
+                  __atomic_store_n(&r->head, head, __ATOMIC_RELEASE);
+            }
+      }
+
+private:
+      Ring* rings;
+};
+
+/**
+ * @brief TCP backend: one connection per pair of workers
+ *
+ * Frames are [length][words...] in host byte order (all workers run the same
+ * binary on the same kind of machine).
+ */
+class TcpTransport : public Transport {
+public:
+      /**
+       * @brief Creates the listening socket of one worker; called before fork()
+       *        so that connections can be queued before the peer accepts
+       */
+      static int listenOn(int port) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd < 0) return -1;
+            int yes = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            sockaddr_in address;
+            memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(port);
+            if (bind(fd, (sockaddr*)&address, sizeof(address)) < 0 || listen(fd, 64) < 0) {
+                  close(fd);
+                  return -1;
+            }
+            return fd;
+      }
+
+      /**
+       * @brief Connects to every lower rank and accepts every higher rank
+       */
+      TcpTransport(int r, int n, int listenFd, int basePort)
+            : Transport(r, n), sockets(n, -1), inputs(n), healthy(true) {
+            for (int peer = 0; peer < rank; peer++) {
+                  int fd = socket(AF_INET, SOCK_STREAM, 0);
+                  sockaddr_in address;
+                  memset(&address, 0, sizeof(address));
+                  address.sin_family = AF_INET;
+                  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                  address.sin_port = htons(basePort + peer);
+                  uint64_t id = rank;
+                  if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) < 0
+                      || write(fd, &id, sizeof(id)) != (ssize_t)sizeof(id)) {
+                        healthy = false;
+                        if (fd >= 0) close(fd);
+                        continue;
+                  }
+                  sockets[peer] = fd;
+            }
+            for (int accepted = 0; accepted < numWorkers - 1 - rank; accepted++) {
+                  int fd = accept(listenFd, nullptr, nullptr);
+                  uint64_t id = 0;
+                  if (fd < 0 || read(fd, &id, sizeof(id)) != (ssize_t)sizeof(id) || id >= (uint64_t)numWorkers) {
+                        healthy = false;
+                        if (fd >= 0) close(fd);
+                        continue;
+                  }
+                  sockets[id] = fd;
+            }
+            for (int peer = 0; peer < numWorkers; peer++) {
+                  if (sockets[peer] < 0) continue;
+                  int yes = 1;
+                  setsockopt(sockets[peer], IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+                  fcntl(sockets[peer], F_SETFL, fcntl(sockets[peer], F_GETFL) | O_NONBLOCK);
+            }
+      }
+
+      ~TcpTransport() {
+            for (int peer = 0; peer < numWorkers; peer++) {
+                  if (sockets[peer] >= 0) close(sockets[peer]);
+            }
+      }
+
+      bool isConnected() const { return healthy; }
+
+protected:
+      void sendRemote(int dest, const vector<uint64_t>& message) {
+            vector<uint64_t> frame;
+            frame.reserve(message.size() + 1);
+            frame.push_back(message.size());
+            frame.insert(frame.end(), message.begin(), message.end());
+
+            const char* data = (const char*)frame.data();
+            size_t remaining = frame.size() * sizeof(uint64_t);
+            while (remaining > 0) {
+                  ssize_t written = ::send(sockets[dest], data, remaining, MSG_NOSIGNAL);
+                  if (written > 0) {
+                        data += written;
+                        remaining -= written;
+                  } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                        // Keep reading while the peer's window is full, or both sides could block
+                        poll();
+                        waitFor(dest);
+                  } else {
+                        cerr << "Error: worker " << rank << " lost connection to worker " << dest << endl;
+                        _exit(1);
+                  }
+            }
+      }
+
+      void poll() {
+            char buffer[65536];
+            for (int peer = 0; peer < numWorkers; peer++) {
+                  if (sockets[peer] < 0) continue;
+                  vector<char>& input = inputs[peer];
+                  while (true) {
+                        ssize_t received = read(sockets[peer], buffer, sizeof(buffer));
+                        if (received <= 0) break;
+                        input.insert(input.end(), buffer, buffer + received);
+                  }
+
+                  // Extract every complete frame
+                  size_t offset = 0;
+                  while (input.size() - offset >= sizeof(uint64_t)) {
+                        uint64_t length;
+                        memcpy(&length, &input[offset], sizeof(length));
+                        size_t frameBytes = (length + 1) * sizeof(uint64_t);
+                        if (input.size() - offset < frameBytes) break;
+                        vector<uint64_t> message(length);
+                        memcpy(message.data(), &input[offset + sizeof(uint64_t)], length * sizeof(uint64_t));
+                        pending.push_back(message);
+                        offset += frameBytes;
+                  }
+                  input.erase(input.begin(), input.begin() + offset);
+            }
+      }
+
+      void waitForData() { waitFor(-1); }
+
+private:
+      /**
+       * @brief Sleeps until a socket is readable (or dest is writable)
+       */
+      void waitFor(int dest) {
+            vector<pollfd> fds;
+            for (int peer = 0; peer < numWorkers; peer++) {
+                  if (sockets[peer] < 0) continue;
+                  pollfd entry;
+                  entry.fd = sockets[peer];
+                  entry.events = POLLIN | (peer == dest ? POLLOUT : 0);
+                  entry.revents = 0;
+                  fds.push_back(entry);
+            }
+            ::poll(fds.data(), fds.size(), 10);
+      }
+
+      vector<int> sockets;
+      vector<vector<char> > inputs;  // Partial frames per peer
+      bool healthy;
+};
+
+// =============================================================================
+// ROUND EXCHANGE
+// =============================================================================
+
+/**
+ * @brief Batching, end-of-round markers and the status all-reduce on top of a Transport
+ *
+ * Because workers leave a round at different times, a worker may receive
+ * STATUS messages while it still waits for DONE markers, and batches or DONE
+ * markers of the next round while it still waits for STATUS messages. Both
+ * are kept aside until the phase they belong to.
+ */
+class RoundExchange {
+public:
+      typedef function<void(const uint64_t* entries, size_t words)> BatchHandler;
+
+      RoundExchange(Transport& t, int n)
+            : transport(t), numWorkers(n), outgoing(n, vector<uint64_t>(1, MESSAGE_BATCH)),
+              doneCount(0), batchesSent(0) {}
+
+      /**
+       * @brief Queues one successor (one or two words) for its owner
+       */
+      void sendState(int dest, uint64_t word) {
+            outgoing[dest].push_back(word);
+            if (outgoing[dest].size() >= BATCH_WORDS) flush(dest);
+      }
+
+      void sendState(int dest, uint64_t word1, uint64_t word2) {
+            outgoing[dest].push_back(word1);
+            outgoing[dest].push_back(word2);
+            if (outgoing[dest].size() >= BATCH_WORDS) flush(dest);
+      }
+
+      /**
+       * @brief Handles the batches that already arrived, without waiting
+       */
+      void drain(const BatchHandler& onBatch) {
+            vector<uint64_t> message;
+            while (next(message, false)) handle(message, onBatch);
+      }
+
+      /**
+       * @brief Ends the expansion phase: flushes every batch, sends DONE and
+       *        handles incoming batches until every worker has sent DONE
+       */
+      void finishExpansion(const BatchHandler& onBatch) {
+            for (int dest = 0; dest < numWorkers; dest++) {
+                  flush(dest);
+                  transport.send(dest, vector<uint64_t>(1, MESSAGE_DONE));
+            }
+            vector<uint64_t> message;
+            while (doneCount < numWorkers) {
+                  next(message, true);
+                  handle(message, onBatch);
+            }
+            doneCount = 0;
+      }
+
+      /**
+       * @brief Exchanges round summaries; every worker gets the same result
+       */
+      Status allReduce(const Status& local) {
+            vector<uint64_t> message;
+            message.push_back(MESSAGE_STATUS);
+            message.push_back(local.size);
+            message.push_back(local.minF);
+            message.push_back(local.found);
+            message.push_back(local.expanded);
+            for (int dest = 0; dest < numWorkers; dest++) transport.send(dest, message);
+
+            Status global;
+            int received = 0;
+            while (received < numWorkers) {
+                  if (!earlyStatus.empty()) {
+                        message.swap(earlyStatus.front());
+                        earlyStatus.pop_front();
+                  } else {
+                        transport.receive(message);
+                        if (message[0] != MESSAGE_STATUS) {
+                              nextRound.push_back(message);
+                              continue;
+                        }
+                  }
+                  global.size += message[1];
+                  global.minF = min(global.minF, message[2]);
+                  global.found = min(global.found, message[3]);
+                  global.expanded += message[4];
+                  received++;
+            }
+            return global;
+      }
+
+      long long getBatchesSent() const { return batchesSent; }
+
+private:
+      void flush(int dest) {
+            if (outgoing[dest].size() <= 1) return;
+            transport.send(dest, outgoing[dest]);
+            outgoing[dest].resize(1);
+            batchesSent++;
+      }
+
+      // Messages of this round: first the ones set aside during the last status exchange
+      bool next(vector<uint64_t>& message, bool wait) {
+            while (true) {
+                  if (!nextRound.empty()) {
+                        message.swap(nextRound.front());
+                        nextRound.pop_front();
+                  } else if (wait) {
+                        transport.receive(message);
+                  } else if (!transport.tryReceive(message)) {
+                        return false;
+                  }
+                  if (message[0] != MESSAGE_STATUS) return true;
+                  earlyStatus.push_back(message);
+            }
+      }
+
+      void handle(const vector<uint64_t>& message, const BatchHandler& onBatch) {
+            if (message[0] == MESSAGE_DONE) {
+                  doneCount++;
+            } else if (message.size() > 1) {
+                  onBatch(&message[1], message.size() - 1);
+            }
+      }
+
+      Transport& transport;
+      int numWorkers;
+      vector<vector<uint64_t> > outgoing;      // Per destination, starts with MESSAGE_BATCH
+      deque<vector<uint64_t> > earlyStatus;    // STATUS received during the expansion phase
+      deque<vector<uint64_t> > nextRound;      // BATCH/DONE received during the status exchange
+      int doneCount;
+      long long batchesSent;
+};
+
+// =============================================================================
+// HEURISTIC TABLES AND PARTITIONING
+// =============================================================================
+
+int manhattan[16][16];  // manhattan[tile][pos]
+int neighbors[16][4];   // neighbors[pos][move], -1 if out of bounds
+
+void buildTables() {
+      for (int tile = 0; tile < 16; tile++) {
+            int goalPos = goalBoard.find(tile == PACKED_BLANK ? '#' : (char)('A' + tile));
+            for (int pos = 0; pos < 16; pos++) {
+                  manhattan[tile][pos] = (tile == PACKED_BLANK) ? 0 :
+                        abs(pos / 4 - goalPos / 4) + abs(pos % 4 - goalPos % 4);
+            }
+      }
+      for (int pos = 0; pos < 16; pos++) {
+            for (int i = 0; i < 4; i++) neighbors[pos][i] = SuccessorTable::square(4).target(pos, i);
+      }
+}
+
+int calculateH2(PackedBoard board) {
+      int totalDistance = 0;
+      for (int pos = 0; pos < 16; pos++) {
+            totalDistance += manhattan[packedTile(board, pos)][pos];
+      }
+      return totalDistance;
+}
+
+/**
+ * @brief Worker that owns a board (Fibonacci hash of the packed board)
+ */
+int owner(PackedBoard board, int numWorkers) {
+      return (int)(((board * 0x9E3779B97F4A7C15ULL) >> 32) % numWorkers);
+}
+
+struct WorkerStats {
+      long long expanded;
+      long long owned;    // States this worker ever stored
+
+      WorkerStats() : expanded(0), owned(0) {}
+};
+
+// =============================================================================
+// DISTRIBUTED BFS
+// =============================================================================
+
+/**
+ * @brief One worker of the level-synchronous distributed BFS
+ * @return Solution depth (the same on every worker), or -1
+ */
+int bfsWorker(RoundExchange& exchange, int rank, int numWorkers, PackedBoard start,
+              PackedBoard goal, WorkerStats& stats, Status& global) {
+      unordered_set<PackedBoard> visited;
+      vector<PackedBoard> frontier;
+      vector<PackedBoard> nextFrontier;
+
+      if (owner(start, numWorkers) == rank) {
+            visited.insert(start);
+            frontier.push_back(start);
+      }
+
+      // The owner decides whether a received successor is new
+      RoundExchange::BatchHandler onBatch = [&](const uint64_t* entries, size_t words) {
+            for (size_t i = 0; i < words; i++) {
+                  if (visited.insert(entries[i]).second) nextFrontier.push_back(entries[i]);
+            }
+      };
+
+      for (int depth = 0; ; depth++) {
+            Status local;
+            for (size_t idx = 0; idx < frontier.size(); idx++) {
+                  PackedBoard board = frontier[idx];
+                  stats.expanded++;
+                  if (board == goal) {
+                        local.found = depth;
+                        break;
+                  }
+
+                  int blankPos = packedBlankPos(board);
+                  for (int i = 0; i < 4; i++) {
+                        int newPos = neighbors[blankPos][i];
+                        if (newPos < 0) continue;
+                        PackedBoard child = packedMove(board, blankPos, newPos);
+                        exchange.sendState(owner(child, numWorkers), child);
+                  }
+                  if ((idx & 1023) == 0) exchange.drain(onBatch);
+            }
+            exchange.finishExpansion(onBatch);
+
+            local.size = nextFrontier.size();
+            local.expanded = stats.expanded;
+            global = exchange.allReduce(local);
+
+            if (global.found != NONE) return (int)global.found;
+            if (global.size == 0) return -1;
+
+            stats.owned = visited.size();
+            frontier.swap(nextFrontier);
+            nextFrontier.clear();
+      }
+}
+
+// =============================================================================
+// DISTRIBUTED A* WITH H2
+// =============================================================================
+
+/**
+ * @brief One worker of the f-layered distributed A*
+ *
+ * Successors travel as (board, g | h << 16). Open lists are bucketed by f;
+ * every round expands the bucket of the globally lowest f on every worker.
+ *
+ * @return Optimal solution length (the same on every worker), or -1
+ */
+int astarWorker(RoundExchange& exchange, int rank, int numWorkers, PackedBoard start,
+                PackedBoard goal, WorkerStats& stats, Status& global) {
+      unordered_map<PackedBoard, int> bestCost;          // Lowest g seen per owned board
+      map<int, vector<pair<PackedBoard, int> > > openList; // f -> (board, g)
+      uint64_t openSize = 0;
+
+      RoundExchange::BatchHandler onBatch = [&](const uint64_t* entries, size_t words) {
+            for (size_t i = 0; i + 1 < words; i += 2) {
+                  PackedBoard board = entries[i];
+                  int cost = (int)(entries[i + 1] & 0xFFFF);
+                  int heuristic = (int)(entries[i + 1] >> 16);
+                  auto it = bestCost.find(board);
+                  if (it != bestCost.end() && it->second <= cost) continue;
+                  if (it == bestCost.end()) stats.owned++;
+                  bestCost[board] = cost;
+                  openList[cost + heuristic].push_back(make_pair(board, cost));
+                  openSize++;
+            }
+      };
+
+      if (owner(start, numWorkers) == rank) {
+            uint64_t entry[2] = {start, (uint64_t)calculateH2(start) << 16};
+            onBatch(entry, 2);
+      }
+
+      Status local;
+      local.size = openSize;
+      local.minF = openList.empty() ? NONE : (uint64_t)openList.begin()->first;
+      global = exchange.allReduce(local);
+
+      while (global.found == NONE && global.minF != NONE) {
+            int currentF = (int)global.minF;
+            local = Status();
+
+            vector<pair<PackedBoard, int> > work;
+            if (!openList.empty() && openList.begin()->first == currentF) {
+                  work.swap(openList.begin()->second);
+                  openList.erase(openList.begin());
+                  openSize -= work.size();
+            }
+
+            for (size_t idx = 0; idx < work.size(); idx++) {
+                  PackedBoard board = work[idx].first;
+                  int cost = work[idx].second;
+                  if (bestCost[board] < cost) continue;  // Reached again with a lower g
+
+                  stats.expanded++;
+                  if (board == goal) {
+                        local.found = cost;
+                        break;
+                  }
+
+                  int blankPos = packedBlankPos(board);
+                  int h2 = currentF - cost;
+                  for (int i = 0; i < 4; i++) {
+                        int newPos = neighbors[blankPos][i];
+                        if (newPos < 0) continue;
+                        int tile = packedTile(board, newPos);
+                        int childH2 = h2 - manhattan[tile][newPos] + manhattan[tile][blankPos];
+                        PackedBoard child = packedMove(board, blankPos, newPos);
+                        exchange.sendState(owner(child, numWorkers), child,
+                                           (uint64_t)(cost + 1) | ((uint64_t)childH2 << 16));
+                  }
+                  if ((idx & 1023) == 0) exchange.drain(onBatch);
+            }
+            exchange.finishExpansion(onBatch);
+
+            local.size = openSize;
+            local.minF = openList.empty() ? NONE : (uint64_t)openList.begin()->first;
+            local.expanded = stats.expanded;
+            global = exchange.allReduce(local);
+      }
+
+      return global.found == NONE ? -1 : (int)global.found;
+}
+
+// =============================================================================
+// WORKER PROCESSES
+// =============================================================================
+
+struct Config {
+      int numWorkers;
+      string algorithm;
+      string transport;
+      int basePort;
+      bool printStats;
+
+      Config() : numWorkers(4), algorithm("astar"), transport("shm"), basePort(47100), printStats(false) {}
+};
+
+/**
+ * @brief Body of one worker process; worker 0 reports the result through resultFd
+ */
+int runWorker(int rank, const Config& config, PackedBoard start, void* region,
+              const vector<int>& listenFds, int resultFd) {
+      Transport* transport;
+      if (config.transport == "tcp") {
+            TcpTransport* tcp = new TcpTransport(rank, config.numWorkers, listenFds[rank], config.basePort);
+            if (!tcp->isConnected()) {
+                  cerr << "Error: worker " << rank << " could not connect to its peers" << endl;
+                  return 1;
+            }
+            transport = tcp;
+      } else {
+            transport = new ShmTransport(rank, config.numWorkers, region);
+      }
+
+      RoundExchange exchange(*transport, config.numWorkers);
+      PackedBoard goal = packBoard(goalBoard);
+      WorkerStats stats;
+      Status global;
+
+      int solution = (config.algorithm == "bfs")
+            ? bfsWorker(exchange, rank, config.numWorkers, start, goal, stats, global)
+            : astarWorker(exchange, rank, config.numWorkers, start, goal, stats, global);
+
+      if (config.printStats) {
+            // One write per line so that the lines of different workers do not interleave
+            ostringstream line;
+            line << "Worker " << rank << ": expanded " << stats.expanded << ", states owned "
+                 << stats.owned << ", batches sent " << exchange.getBatchesSent() << "\n";
+            cerr << line.str() << flush;
+      }
+
+      if (rank == 0) {
+            char line[64];
+            int length = snprintf(line, sizeof(line), "%d %llu\n", solution, (unsigned long long)global.expanded);
+            if (write(resultFd, line, length) != length) {
+                  delete transport;
+                  return 1;
+            }
+      }
+
+      delete transport;
+      return 0;
+}
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+int main(int argc, char* argv[]) {
+      Config config;
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+                  config.numWorkers = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--algo") == 0 && i + 1 < argc) {
+                  config.algorithm = argv[++i];
+            } else if (strcmp(argv[i], "--transport") == 0 && i + 1 < argc) {
+                  config.transport = argv[++i];
+            } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+                  config.basePort = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  config.printStats = true;
+            } else {
+                  cerr << "Usage: " << argv[0] << " [--workers N] [--algo bfs|astar]"
+                       << " [--transport shm|tcp] [--port P] [--stats] < \"puzzle [goal]\"" << endl;
+                  return 1;
+            }
+      }
+      if (config.numWorkers < 1 || config.numWorkers > 64
+          || (config.algorithm != "bfs" && config.algorithm != "astar")
+          || (config.transport != "shm" && config.transport != "tcp")) {
+            cerr << "Error: invalid options (1-64 workers, bfs|astar, shm|tcp)" << endl;
+            return 1;
+      }
+
+      string puzzle, goal;
+      cin >> puzzle;
+
+      // Optional custom goal: searched for directly, the blank may be anywhere
+      if (!(cin >> goal)) goal = TARGET;
+      if (!sameTiles(puzzle, goal, TARGET)) {
+            cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+            return 1;
+      }
+      if (!goalReachable(puzzle, goal, 4)) {
+            cout << -1 << endl;
+            return 0;
+      }
+      goalBoard = goal;
+
+      buildTables();
+
+      // Channels are created before fork() so that every worker inherits them
+      void* region = nullptr;
+      vector<int> listenFds(config.numWorkers, -1);
+      if (config.transport == "shm") {
+            region = ShmTransport::createRegion(config.numWorkers);
+            if (!region) {
+                  cerr << "Error: cannot map shared memory for " << config.numWorkers << " workers" << endl;
+                  return 1;
+            }
+      } else {
+            for (int rank = 0; rank < config.numWorkers; rank++) {
+                  listenFds[rank] = TcpTransport::listenOn(config.basePort + rank);
+                  if (listenFds[rank] < 0) {
+                        cerr << "Error: cannot listen on port " << config.basePort + rank << endl;
+                        return 1;
+                  }
+            }
+      }
+
+      int resultPipe[2];
+      if (pipe(resultPipe) != 0) {
+            cerr << "Error: cannot create result pipe" << endl;
+            return 1;
+      }
+
+      auto startTime = high_resolution_clock::now();
+
+      PackedBoard start = packBoard(puzzle);
+      vector<pid_t> children;
+      for (int rank = 0; rank < config.numWorkers; rank++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                  close(resultPipe[0]);
+                  for (int other = 0; other < config.numWorkers; other++) {
+                        if (other != rank && listenFds[other] >= 0) close(listenFds[other]);
+                  }
+                  int status = runWorker(rank, config, start, region, listenFds, resultPipe[1]);
+                  fflush(stderr);
+                  _exit(status);
+            }
+            children.push_back(pid);
+      }
+      close(resultPipe[1]);
+      for (int rank = 0; rank < config.numWorkers; rank++) {
+            if (listenFds[rank] >= 0) close(listenFds[rank]);
+      }
+
+      // Worker 0 writes "solution expanded"; an empty pipe means it failed
+      string result;
+      char buffer[64];
+      ssize_t received;
+      while ((received = read(resultPipe[0], buffer, sizeof(buffer))) > 0) result.append(buffer, received);
+      close(resultPipe[0]);
+
+      bool failed = false;
+      for (size_t i = 0; i < children.size(); i++) {
+            int status;
+            waitpid(children[i], &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = true;
+      }
+
+      auto endTime = high_resolution_clock::now();
+      double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
+
+      int solution = -1;
+      unsigned long long expanded = 0;
+      if (failed || sscanf(result.c_str(), "%d %llu", &solution, &expanded) != 2) {
+            cerr << "Error: a worker failed" << endl;
+            return 1;
+      }
+
+      cout << solution << endl;
+      if (config.printStats) {
+            cerr << "Nodes expanded: " << expanded << endl;
+            cerr << "Time: " << timeMs << " ms" << endl;
+      }
+      return 0;
+}
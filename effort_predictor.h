@@ -0,0 +1,345 @@
+/**
+ * @file effort_predictor.h
+ * @brief Predicts the nodes BFS, A* and IDA* will need before the solve starts
+ *
+ * Three cheap measurements of the start state, all with the Manhattan
+ * heuristic the h2 solvers use and the move-pruning automaton they expand
+ * with:
+ *
+ *   1. Stratified sampling (Chen 1992, a refinement of Knuth's estimator).
+ *      One probe walks the IDA* tree of threshold T level by level, keeping
+ *      one representative per type (here h and the blank cell) with the summed
+ *      weight of every node of that type; a child replaces the
+ *      representative with probability weight / total weight. The weights
+ *      summed over all levels are an unbiased estimate of the nodes with
+ *      f <= T, and the weight of nodes with small h estimates how many paths
+ *      get near the goal within T. Many probes are averaged.
+ *   2. The predicted solution length is the first threshold (stepping by 2,
+ *      the parity of h) at which about 10 paths reach h <= 4. Paths to the
+ *      goal itself are too rare for the probes to see on deep instances;
+ *      near-goal nodes are not, and are usually solved within the same f.
+ *      The depth is exact on short instances. On 40 boards of depth 40-44
+ *      the mean error is 2.3 moves (at most 8, usually too short), and the
+ *      predicted IDA* nodes are off by 0.02x-170x (median 1.1x, 80% within
+ *      0.16x-27x): HGJBIMAD#CELNKFO is predicted at 36 moves and 1.0e4
+ *      nodes, and needs 40 moves and 1.7e5 nodes. Deep predictions only
+ *      rank instances and choose engines; they do not bound memory.
+ *   3. A small exact BFS from the start gives the first layer sizes; the
+ *      growth of the last layers is extrapolated to the predicted depth. If
+ *      the goal appears within the probe the depth is exact.
+ *
+ * From the depth: IDA* expands the trees of every threshold up to it, A*
+ * (high-g tie-breaking) about the tree of the previous threshold without
+ * its transpositions (so at most the BFS states), BFS every state closer
+ * than the depth. Memory and time follow from per-node costs; the thread
+ * count is chosen so every thread gets enough work to amortize its start.
+ *
+ * Boards are "ABC...#" strings of a 3x3, 4x4 or 5x5 puzzle with the
+ * canonical goal (the solvers relabel custom goals first).
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef EFFORT_PREDICTOR_H
+#define EFFORT_PREDICTOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+
+/**
+ * @brief Predicted effort of one start state
+ */
+struct EffortPrediction {
+      int heuristic;          // Manhattan distance of the start
+      int depth;              // Predicted optimal solution length
+      bool exactDepth;        // Depth found by the BFS probe (not a prediction)
+      double idaNodes;        // IDA*: nodes expanded over all iterations
+      double astarNodes;      // A*: nodes expanded (f < depth)
+      double bfsNodes;        // BFS: states expanded (closer than depth)
+      double bfsStates;       // BFS: states stored (up to depth)
+};
+
+/**
+ * @brief Recommended engine for a prediction
+ */
+struct EffortChoice {
+      std::string engine;     // "bfs", "astar-h2" or "idastar"
+      int threads;
+      double memoryBytes;     // Budget the engine is expected to need
+      double seconds;         // Predicted wall time with that many threads
+};
+
+// Per-engine cost model (16-byte packed states, hash tables with their overhead).
+// Rates are expansions per second per thread of the solvers in this repo.
+const double EFFORT_BFS_BYTES_PER_STATE = 48;
+const double EFFORT_ASTAR_BYTES_PER_NODE = 160;   // closed entry + ~2 open entries
+const double EFFORT_IDA_BYTES = 1 << 16;          // recursion stack and subtrees
+const double EFFORT_BFS_RATE = 5e5;
+const double EFFORT_ASTAR_RATE = 5e5;
+const double EFFORT_IDA_RATE = 25e6;
+const double EFFORT_PARALLEL_EFFICIENCY[] = {0.7, 0.5, 0.9};  // bfs, astar-h2, idastar
+const double EFFORT_NODES_PER_THREAD = 2e5;       // Smallest useful share of work
+
+// Depth rule: nodes this close to the goal (by h) within the threshold,
+// counted over all paths, before the threshold is taken as the solution length
+const int EFFORT_NEAR_GOAL_H = 4;
+const double EFFORT_NEAR_GOAL_PATHS = 10;
+
+class EffortPredictor {
+public:
+      /**
+       * @param size     Board side (3, 4 or 5)
+       * @param probes   Stratified-sampling probes per threshold
+       * @param seed     Seed of the probes (predictions are reproducible)
+       */
+      explicit EffortPredictor(int size, int probes = 128, uint64_t seed = 1)
+            : n(size), cells(size * size), probeCount(probes), state(seed),
+              bfsProbeStates(size == 3 ? 200000 : 50000), maxTreeNodes(1e15) {}
+
+      EffortPrediction predict(const std::string& board) {
+            Node root = parse(board);
+            EffortPrediction p;
+            p.heuristic = root.h;
+
+            std::vector<double> layers;
+            int found = bfsProbe(board, layers);
+            p.exactDepth = found >= 0;
+
+            // Thresholds h, h+2, ... until the goal is expected within the bound
+            double ida = 0, previousTree = 0;
+            int threshold = root.h;
+            while (true) {
+                  double goals = 0;
+                  double tree = sampleTree(root, threshold, goals);
+                  bool done = p.exactDepth ? threshold >= found : goals >= EFFORT_NEAR_GOAL_PATHS;
+                  if (done || ida + tree > maxTreeNodes) {
+                        ida += tree;
+                        break;
+                  }
+                  ida += tree;
+                  previousTree = tree;
+                  threshold += 2;
+            }
+            p.depth = threshold;
+            p.idaNodes = ida;
+
+            // BFS expands the states closer than the depth and stores those at it
+            double expanded = 0, stored = 0;
+            for (int d = 0; d <= p.depth; d++) {
+                  double layer = layerSize(layers, d);
+                  if (d < p.depth) expanded += layer;
+                  stored += layer;
+            }
+            double reachable = reachableStates();
+            p.bfsNodes = std::min(expanded, reachable);
+            p.bfsStates = std::min(stored, reachable);
+            p.astarNodes = std::max((double)p.depth, std::min(previousTree, p.bfsNodes));
+            return p;
+      }
+
+      /**
+       * @brief Picks the engine with the shortest predicted time that fits the memory limit
+       *        (IDA* always fits), and the threads worth giving it
+       */
+      static EffortChoice choose(const EffortPrediction& p, int maxThreads, double memoryLimit) {
+            const char* names[] = {"bfs", "astar-h2", "idastar"};
+            double nodes[] = {p.bfsNodes, p.astarNodes, p.idaNodes};
+            double rates[] = {EFFORT_BFS_RATE, EFFORT_ASTAR_RATE, EFFORT_IDA_RATE};
+            double memory[] = {p.bfsStates * EFFORT_BFS_BYTES_PER_STATE,
+                               p.astarNodes * EFFORT_ASTAR_BYTES_PER_NODE, EFFORT_IDA_BYTES};
+
+            EffortChoice best;
+            best.seconds = -1;
+            for (int e = 0; e < 3; e++) {
+                  if (e < 2 && memory[e] > memoryLimit) continue;
+                  int threads = (int)std::min<double>(maxThreads, std::max(1.0, nodes[e] / EFFORT_NODES_PER_THREAD));
+                  double speedup = 1 + (threads - 1) * EFFORT_PARALLEL_EFFICIENCY[e];
+                  double seconds = nodes[e] / (rates[e] * speedup);
+                  if (best.seconds < 0 || seconds < best.seconds) {
+                        best.engine = names[e];
+                        best.threads = threads;
+                        best.memoryBytes = memory[e];
+                        best.seconds = seconds;
+                  }
+            }
+            return best;
+      }
+
+      /**
+       * @brief Stratified-sampling estimate of the IDA* tree with f <= threshold
+       * @param goals Receives the estimated number of paths within the threshold
+       *              reaching a node with h <= EFFORT_NEAR_GOAL_H
+       */
+      double sampleTree(const std::string& board, int threshold, double& goals) {
+            return sampleTree(parse(board), threshold, goals);
+      }
+
+private:
+      static const int MAX_CELLS = 25;
+      static const int MAX_TYPES = 256 * MAX_CELLS;  // (h, blank); Manhattan of a 5x5 board stays below 256
+
+      struct Node {
+            uint8_t cells[MAX_CELLS];    // tile numbers, blank = cells - 1
+            int blankPos;
+            int g;
+            int h;
+            int pruneState;
+      };
+
+      struct Sample {
+            Node node;
+            double weight;
+      };
+
+      int tileDistance(int tile, int pos) const {
+            return std::abs(pos / n - tile / n) + std::abs(pos % n - tile % n);
+      }
+
+      Node parse(const std::string& board) const {
+            Node node;
+            node.h = 0;
+            for (int pos = 0; pos < cells; pos++) {
+                  int tile = board[pos] == '#' ? cells - 1 : board[pos] - 'A';
+                  node.cells[pos] = tile;
+                  if (tile == cells - 1) node.blankPos = pos;
+                  else node.h += tileDistance(tile, pos);
+            }
+            node.g = 0;
+            node.pruneState = MOVE_PRUNING_START;
+            return node;
+      }
+
+      double random() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return ((z ^ (z >> 31)) >> 11) * (1.0 / 9007199254740992.0);
+      }
+
+      double sampleTree(const Node& root, int threshold, double& goals) {
+            const SuccessorTable& moves = SuccessorTable::square(n);
+
+            double total = 0;
+            goals = 0;
+            std::vector<Sample> level, next(MAX_TYPES);
+            std::vector<int> used;
+            for (int probe = 0; probe < probeCount; probe++) {
+                  Sample first = {root, 1.0};
+                  level.assign(1, first);
+                  while (!level.empty()) {
+                        used.clear();
+                        for (size_t i = 0; i < level.size(); i++) {
+                              const Node& node = level[i].node;
+                              double weight = level[i].weight;
+                              total += weight;
+                              if (node.h <= EFFORT_NEAR_GOAL_H) goals += weight;
+                              if (node.h == 0) {
+                                    continue;
+                              }
+                              for (int k = 0; k < moves.count(node.blankPos); k++) {
+                                    int nextState = MOVE_PRUNING_NEXT[node.pruneState][moves.move(node.blankPos, k)];
+                                    if (nextState < 0) continue;
+
+                                    int newPos = moves.neighbor(node.blankPos, k);
+                                    int tile = node.cells[newPos];
+                                    int h = node.h + tileDistance(tile, node.blankPos) - tileDistance(tile, newPos);
+                                    if (node.g + 1 + h > threshold) continue;
+
+                                    // One representative per h, with the summed weight of the stratum
+                                    int type = h * cells + newPos;
+                                    Sample& slot = next[type];
+                                    if (slot.weight == 0) used.push_back(type);
+                                    slot.weight += weight;
+                                    if (slot.weight == weight || random() * slot.weight < weight) {
+                                          slot.node = node;
+                                          slot.node.cells[node.blankPos] = tile;
+                                          slot.node.cells[newPos] = cells - 1;
+                                          slot.node.blankPos = newPos;
+                                          slot.node.g = node.g + 1;
+                                          slot.node.h = h;
+                                          slot.node.pruneState = nextState;
+                                    }
+                              }
+                        }
+                        level.clear();
+                        for (size_t i = 0; i < used.size(); i++) {
+                              level.push_back(next[used[i]]);
+                              next[used[i]].weight = 0;
+                        }
+                  }
+            }
+            goals /= probeCount;
+            return total / probeCount;
+      }
+
+      /**
+       * @brief Exact BFS from the start until bfsProbeStates states are stored
+       * @return the solution length if the goal was reached, else -1
+       */
+      int bfsProbe(const std::string& board, std::vector<double>& layers) const {
+            std::string goal;
+            for (int i = 0; i < cells - 1; i++) goal += (char)('A' + i);
+            goal += '#';
+
+            const SuccessorTable& moves = SuccessorTable::square(n);
+            std::unordered_set<std::string> visited;
+            std::vector<std::string> frontier(1, board), next;
+            visited.insert(board);
+            layers.assign(1, 1);
+            if (board == goal) return 0;
+
+            while (!frontier.empty() && visited.size() < bfsProbeStates) {
+                  next.clear();
+                  for (size_t i = 0; i < frontier.size(); i++) {
+                        int blank = frontier[i].find('#');
+                        for (int k = 0; k < moves.count(blank); k++) {
+                              std::string child = frontier[i];
+                              std::swap(child[blank], child[moves.neighbor(blank, k)]);
+                              if (!visited.insert(child).second) continue;
+                              if (child == goal) {
+                                    layers.push_back(next.size() + 1);
+                                    return layers.size() - 1;
+                              }
+                              next.push_back(child);
+                        }
+                  }
+                  if (next.empty()) break;
+                  layers.push_back(next.size());
+                  frontier.swap(next);
+            }
+            return -1;
+      }
+
+      /**
+       * @brief Layer d of the BFS: measured, or extrapolated with the growth of the last layers
+       */
+      double layerSize(const std::vector<double>& layers, int d) const {
+            if (d < (int)layers.size()) return layers[d];
+            size_t last = layers.size() - 1;
+            double growth = last >= 2 ? std::sqrt(layers[last] / layers[last - 2]) : 2.0;
+            return layers[last] * std::pow(growth, d - (int)last);
+      }
+
+      double reachableStates() const {
+            double states = 0.5;
+            for (int i = 2; i <= cells; i++) states *= i;
+            return states;
+      }
+
+      int n;
+      int cells;
+      int probeCount;
+      uint64_t state;
+      size_t bfsProbeStates;
+      double maxTreeNodes;
+};
+
+#endif // EFFORT_PREDICTOR_H
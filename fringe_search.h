@@ -0,0 +1,189 @@
+/**
+ * @file fringe_search.h
+ * @brief Fringe Search: threshold iterations like IDA*, without restarting from the root
+ *
+ * Fringe Search (Björnsson et al., 2005) keeps the frontier between
+ * iterations instead of restarting from the root like IDA*, and visits it in
+ * list order instead of keeping a priority queue sorted like A*:
+ *
+ *   - "now" holds the nodes still to visit in this iteration. The head is
+ *     taken; if f <= threshold it is expanded and its children are pushed
+ *     on the head of "now" (depth-first order), otherwise it moves to "later"
+ *     and the smallest such f becomes the next threshold.
+ *   - When "now" is empty, "later" becomes "now" and the threshold rises.
+ *
+ * Both lists are doubly linked through the node arena (indices, not
+ * pointers), so moving a node between lists or unlinking a node reached
+ * again by a cheaper path is O(1). A node is re-opened only when a strictly
+ * cheaper path to it is found. The goal is accepted when it is visited with
+ * f <= threshold, which is optimal for the same reason as in IDA*.
+ *
+ * The heuristic is the same function the A* solvers use (int(const string&)).
+ * An optional StopToken is polled while expanding; a stopped search returns
+ * CANCELLED.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef FRINGE_SEARCH_H
+#define FRINGE_SEARCH_H
+
+#include <climits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "stop_token.h"
+
+class FringeSearch {
+public:
+      typedef int (*Heuristic)(const std::string& board);
+
+      static const int CANCELLED = -2;
+
+      FringeSearch(int size, const std::string& goal, Heuristic h)
+            : n(size), target(goal), heuristic(h), stop(0), expandedNodes(0), iterationCount(0) {}
+
+      /**
+       * @brief Makes solve() return CANCELLED soon after the token is raised
+       */
+      void setStopToken(const StopToken* token) { stop = token; }
+
+      /**
+       * @brief Minimum number of moves from start to the goal, -1 if unsolvable,
+       *        CANCELLED if the stop token was raised
+       */
+      int solve(const std::string& start) {
+            const SuccessorTable& moves = SuccessorTable::square(n);
+
+            nodes.clear();
+            index.clear();
+            expandedNodes = 0;
+            iterationCount = 0;
+            heads[NOW] = heads[LATER] = -1;
+
+            int root = addNode(start, (int)start.find('#'), 0, heuristic(start), MOVE_PRUNING_START);
+            pushFront(NOW, root);
+            int threshold = nodes[root].g + nodes[root].h;
+
+            while (heads[NOW] >= 0) {
+                  iterationCount++;
+                  int nextThreshold = INT_MAX;
+
+                  while (heads[NOW] >= 0) {
+                        int current = heads[NOW];
+                        int f = nodes[current].g + nodes[current].h;
+                        if (f > threshold) {
+                              unlink(current);
+                              pushFront(LATER, current);
+                              if (f < nextThreshold) nextThreshold = f;
+                              continue;
+                        }
+
+                        if (nodes[current].board == target) return nodes[current].g;
+
+                        unlink(current);
+                        if ((++expandedNodes & 1023) == 0 && stop && stop->stopRequested()) return CANCELLED;
+
+                        int blank = nodes[current].blankPos;
+                        for (int k = 0; k < moves.count(blank); k++) {
+                              int pruneState = MOVE_PRUNING_NEXT[nodes[current].pruneState][moves.move(blank, k)];
+                              if (pruneState < 0) continue;
+
+                              int newPos = moves.neighbor(blank, k);
+                              std::string board = nodes[current].board;
+                              std::swap(board[blank], board[newPos]);
+                              int g = nodes[current].g + 1;
+
+                              std::unordered_map<std::string, int>::iterator found = index.find(board);
+                              int child;
+                              if (found == index.end()) {
+                                    child = addNode(board, newPos, g, heuristic(board), pruneState);
+                              } else {
+                                    // Keep the cheapest path only
+                                    child = found->second;
+                                    if (g >= nodes[child].g) continue;
+                                    nodes[child].g = g;
+                                    nodes[child].pruneState = pruneState;
+                                    if (nodes[child].list != NONE) unlink(child);
+                              }
+                              pushFront(NOW, child);
+                        }
+                  }
+
+                  // Everything left is above the old threshold
+                  threshold = nextThreshold;
+                  heads[NOW] = heads[LATER];
+                  heads[LATER] = -1;
+                  for (int node = heads[NOW]; node >= 0; node = nodes[node].next) {
+                        nodes[node].list = NOW;
+                  }
+            }
+            return -1;
+      }
+
+      long long expanded() const { return expandedNodes; }
+
+      int iterations() const { return iterationCount; }
+
+      size_t storedNodes() const { return nodes.size(); }
+
+private:
+      enum ListId { NOW = 0, LATER = 1, NONE = 2 };
+
+      struct Node {
+            std::string board;
+            int blankPos;
+            int g;
+            int h;
+            int pruneState;
+            int prev;
+            int next;
+            int list;
+      };
+
+      int addNode(const std::string& board, int blankPos, int g, int h, int pruneState) {
+            Node node;
+            node.board = board;
+            node.blankPos = blankPos;
+            node.g = g;
+            node.h = h;
+            node.pruneState = pruneState;
+            node.prev = node.next = -1;
+            node.list = NONE;
+            nodes.push_back(node);
+            index[board] = nodes.size() - 1;
+            return nodes.size() - 1;
+      }
+
+      void pushFront(int list, int node) {
+            nodes[node].list = list;
+            nodes[node].prev = -1;
+            nodes[node].next = heads[list];
+            if (heads[list] >= 0) nodes[heads[list]].prev = node;
+            heads[list] = node;
+      }
+
+      void unlink(int node) {
+            Node& entry = nodes[node];
+            if (entry.prev >= 0) nodes[entry.prev].next = entry.next;
+            else heads[entry.list] = entry.next;
+            if (entry.next >= 0) nodes[entry.next].prev = entry.prev;
+            entry.prev = entry.next = -1;
+            entry.list = NONE;
+      }
+
+      int n;
+      std::string target;
+      Heuristic heuristic;
+      const StopToken* stop;
+      std::vector<Node> nodes;                    // arena; lists link by index
+      std::unordered_map<std::string, int> index; // board -> arena index
+      int heads[2];                               // first node of NOW and LATER
+      long long expandedNodes;
+      int iterationCount;
+};
+
+#endif // FRINGE_SEARCH_H
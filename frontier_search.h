@@ -0,0 +1,265 @@
+/**
+ * @file frontier_search.h
+ * @brief Breadth-first frontier search with divide-and-conquer path recovery
+ *
+ * A BFS keeps every visited state only so that it never generates a parent
+ * again. Frontier search (Korf) gets the same effect from the open layers
+ * alone: every open state carries one "used operator" bit per move, set for
+ * the moves that lead back to states already generated. Expanding a state
+ * skips its used operators, and a child gets the bit of the move back to its
+ * parent (ORed over all of its parents), so closed states are never reached
+ * again. The sliding-tile graph is bipartite (every move changes the colour
+ * of the blank's cell), so no move joins two states of the same layer: only
+ * the layer being expanded and the layer being built are stored, and memory
+ * is proportional to the widest layer instead of the whole explored space.
+ *
+ * Without a closed list there are no parent pointers to follow back. Every
+ * state carries a relay instead: its ancestor in a layer near the middle of
+ * the search. When the goal is reached its relay splits the problem into
+ * start -> relay and relay -> goal, each solved the same way, until the
+ * pieces are single moves. Those searches know their depth, so their relay
+ * layer is exactly the middle one; the first search does not, so a state
+ * becomes its own relay at the first layer where g >= h (Manhattan distance
+ * to the goal), an estimate of the halfway point.
+ *
+ * The caller describes the board representation with a class providing:
+ *   typedef ... State;                                  // hashable
+ *   int side() const;                                   // n of the n x n board
+ *   int blank(const State& s) const;                    // cell of the blank
+ *   int tile(const State& s, int cell) const;           // tile id, 0..255
+ *   State slide(const State& s, int blank, int target) const;
+ *
+ * Layers are expanded by numThreads OpenMP threads (one bucket range of the
+ * hash table each) when the program is compiled with -fopenmp; without it
+ * the pragmas are left out and the same loops run on one thread.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef FRONTIER_SEARCH_H
+#define FRONTIER_SEARCH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "successor_table.h"
+
+template <class Space>
+class FrontierSearch {
+public:
+      typedef typename Space::State State;
+
+      FrontierSearch(const Space& s, int threads)
+            : space(s), successors(SuccessorTable::square(s.side())), numThreads(std::max(1, threads)),
+              firstNodes(0), recoveryNodes(0), peak(0), searchCount(0) {}
+
+      /**
+       * @brief Called with (depth, states) after every layer of the first search
+       */
+      void setLayerCallback(std::function<void(int, size_t)> callback) { layerReport = callback; }
+
+      /**
+       * @brief Shortest path from start to goal
+       * @param path Output: the blank moves as "UDLR" letters
+       * @return Number of moves, -1 if the goal cannot be reached
+       */
+      int solve(const State& start, const State& goal, std::string& path) {
+            path.clear();
+            Entry found;
+            int depth = layerSearch(start, goal, -1, found, firstNodes);
+            if (depth < 0) return -1;
+            if (found.relayDepth <= 0 || found.relayDepth >= depth) {
+                  recover(start, goal, depth, path);
+            } else {
+                  recover(start, found.relay, found.relayDepth, path);
+                  recover(found.relay, goal, depth - found.relayDepth, path);
+            }
+            return depth;
+      }
+
+      /** @brief States expanded by the search that found the depth */
+      long long searchNodes() const { return firstNodes; }
+
+      /** @brief States expanded by the searches that rebuilt the path */
+      long long pathNodes() const { return recoveryNodes; }
+
+      /** @brief Largest number of states stored at once (two layers) */
+      size_t peakStates() const { return peak; }
+
+      /** @brief Layer searches run, the first one included */
+      int searches() const { return searchCount; }
+
+private:
+      static const int NO_RELAY = -1;
+      static const size_t MERGE_BATCH = 4096;
+
+      struct Entry {
+            State relay;     // Ancestor in the relay layer, when relayDepth >= 0
+            int relayDepth;
+            unsigned used;   // Bit m: move m leads to a state already generated
+      };
+
+      struct Child {
+            State state;
+            Entry entry;
+      };
+
+      typedef std::unordered_map<State, Entry> Layer;
+
+      /**
+       * @brief Frontier BFS from start until the goal layer
+       * @param knownDepth Depth of the goal when known (relays in its middle layer), -1 otherwise
+       * @param found Output: the goal's entry, with its relay
+       * @return Depth of the goal, -1 if the search ran out of states
+       */
+      int layerSearch(const State& start, const State& goal, int knownDepth, Entry& found, long long& nodes) {
+            searchCount++;
+            int relayLayer = knownDepth >= 0 ? knownDepth / 2 : NO_RELAY;
+            if (relayLayer == NO_RELAY) setGoal(goal);
+
+            Layer current, next;
+            Entry root;
+            root.relayDepth = NO_RELAY;
+            root.used = 0;
+            assignRelay(start, 0, relayLayer, root);
+            current.insert(std::make_pair(start, root));
+
+            for (int depth = 0; !current.empty(); depth++) {
+                  typename Layer::const_iterator goalEntry = current.find(goal);
+                  if (goalEntry != current.end()) {
+                        found = goalEntry->second;
+                        return depth;
+                  }
+                  if (knownDepth >= 0 && depth >= knownDepth) break;
+
+                  nodes += expandLayer(current, next, depth + 1, relayLayer);
+                  peak = std::max(peak, current.size() + next.size());
+                  if (layerReport && knownDepth < 0) layerReport(depth + 1, next.size());
+
+                  // Only the new layer is kept
+                  current.swap(next);
+                  Layer().swap(next);
+            }
+            return -1;
+      }
+
+      long long expandLayer(const Layer& current, Layer& next, int childDepth, int relayLayer) {
+            static const int INVERSE[4] = {1, 0, 3, 2};
+            long long expanded = 0;
+            long long buckets = current.bucket_count();
+
+#ifdef _OPENMP
+            #pragma omp parallel num_threads(numThreads) reduction(+:expanded)
+#endif
+            {
+                  std::vector<Child> local;
+#ifdef _OPENMP
+                  #pragma omp for schedule(dynamic, 256)
+#endif
+                  for (long long b = 0; b < buckets; b++) {
+                        for (typename Layer::const_local_iterator it = current.begin(b); it != current.end(b); ++it) {
+                              expanded++;
+                              int blank = space.blank(it->first);
+                              for (int k = 0; k < successors.count(blank); k++) {
+                                    int move = successors.move(blank, k);
+                                    if (it->second.used & (1u << move)) continue;
+                                    Child child;
+                                    child.state = space.slide(it->first, blank, successors.neighbor(blank, k));
+                                    child.entry = it->second;
+                                    child.entry.used = 1u << INVERSE[move];
+                                    assignRelay(child.state, childDepth, relayLayer, child.entry);
+                                    local.push_back(child);
+                              }
+                              if (local.size() >= MERGE_BATCH) merge(next, local);
+                        }
+                  }
+                  merge(next, local);
+            }
+            return expanded;
+      }
+
+      /**
+       * @brief Adds children to the layer being built; a child generated by
+       *        several parents keeps the first relay and all their bits
+       */
+      void merge(Layer& next, std::vector<Child>& children) {
+#ifdef _OPENMP
+            #pragma omp critical(frontier_merge)
+#endif
+            {
+                  for (size_t i = 0; i < children.size(); i++) {
+                        std::pair<typename Layer::iterator, bool> slot =
+                              next.insert(std::make_pair(children[i].state, children[i].entry));
+                        if (!slot.second) slot.first->second.used |= children[i].entry.used;
+                  }
+            }
+            children.clear();
+      }
+
+      void assignRelay(const State& state, int depth, int relayLayer, Entry& entry) const {
+            if (entry.relayDepth != NO_RELAY) return;
+            bool middle = relayLayer != NO_RELAY ? depth == relayLayer : depth >= manhattan(state);
+            if (!middle) return;
+            entry.relay = state;
+            entry.relayDepth = depth;
+      }
+
+      /**
+       * @brief Appends the moves of a shortest start -> goal path of known length
+       */
+      void recover(const State& start, const State& goal, int depth, std::string& path) {
+            if (depth == 0) return;
+            int blank = space.blank(start);
+            if (depth == 1) {
+                  for (int k = 0; k < successors.count(blank); k++) {
+                        if (space.slide(start, blank, successors.neighbor(blank, k)) == goal) {
+                              path += SuccessorTable::moveLetter(successors.move(blank, k));
+                              return;
+                        }
+                  }
+                  return;
+            }
+            Entry found;
+            layerSearch(start, goal, depth, found, recoveryNodes);
+            recover(start, found.relay, found.relayDepth, path);
+            recover(found.relay, goal, depth - found.relayDepth, path);
+      }
+
+      void setGoal(const State& goal) {
+            goalCell.assign(256, 0);
+            for (int cell = 0; cell < side() * side(); cell++) goalCell[space.tile(goal, cell)] = cell;
+            blankTile = space.tile(goal, space.blank(goal));
+      }
+
+      int manhattan(const State& state) const {
+            int n = side(), h = 0;
+            for (int cell = 0; cell < n * n; cell++) {
+                  int tile = space.tile(state, cell);
+                  if (tile == blankTile) continue;
+                  int target = goalCell[tile];
+                  h += std::abs(cell / n - target / n) + std::abs(cell % n - target % n);
+            }
+            return h;
+      }
+
+      int side() const { return space.side(); }
+
+      const Space& space;
+      const SuccessorTable& successors;
+      int numThreads;
+      std::function<void(int, size_t)> layerReport;
+      std::vector<int> goalCell;  // Goal cell of every tile id (first search only)
+      int blankTile;
+      long long firstNodes;
+      long long recoveryNodes;
+      size_t peak;
+      int searchCount;
+};
+
+#endif // FRONTIER_SEARCH_H
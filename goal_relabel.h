@@ -0,0 +1,141 @@
+/**
+ * @file goal_relabel.h
+ * @brief Support for arbitrary goal boards
+ *
+ * Any goal that uses the tiles of the canonical one is accepted. Engines that
+ * only compare boards (BFS) or compute Manhattan distances work on the goal
+ * itself: sameTiles() validates it, goalReachable() replaces the canonical
+ * parity test and goalCells() gives the goal cell of every tile for the
+ * distance tables.
+ *
+ * Precomputed tables (pattern databases, distance caches) only exist for the
+ * canonical goal. Solving start -> goal is the same problem as solving
+ * T(start) -> T(goal) for any relabelling of the tiles and any symmetry of
+ * the square board, because both preserve the move graph: relabelToCanonical()
+ * picks the symmetry that puts the goal blank on the canonical blank cell and
+ * the relabelling that turns the goal into the canonical target. A symmetry
+ * only moves the blank between corners, so that route needs the goal blank in
+ * a corner (goalBlankInCorner()); engines fall back to plain Manhattan for
+ * other goals.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef GOAL_RELABEL_H
+#define GOAL_RELABEL_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ * @brief Maps a cell of an NxN board through one of the 8 square symmetries
+ * @param symmetry Bit 2: transpose, bit 0: flip rows, bit 1: flip columns
+ */
+inline int transformCell(int pos, int n, int symmetry) {
+      int row = pos / n;
+      int col = pos % n;
+      if (symmetry & 4) std::swap(row, col);
+      if (symmetry & 1) row = n - 1 - row;
+      if (symmetry & 2) col = n - 1 - col;
+      return row * n + col;
+}
+
+/**
+ * @brief Whether start and goal both hold exactly the tiles of canonical
+ */
+inline bool sameTiles(const std::string& start, const std::string& goal, const std::string& canonical) {
+      std::string sortedStart = start, sortedGoal = goal, sortedCanonical = canonical;
+      std::sort(sortedStart.begin(), sortedStart.end());
+      std::sort(sortedGoal.begin(), sortedGoal.end());
+      std::sort(sortedCanonical.begin(), sortedCanonical.end());
+      return sortedStart == sortedCanonical && sortedGoal == sortedCanonical;
+}
+
+/**
+ * @brief Whether goal can be reached from start on an NxN board
+ *
+ * Every move swaps the blank with a neighbour: it is one transposition of
+ * the cells and changes the colour of the blank's cell. The permutation that
+ * turns start into goal must therefore have the parity of the blank's
+ * Manhattan distance between the two boards (and that is also sufficient).
+ */
+inline bool goalReachable(const std::string& start, const std::string& goal, int n) {
+      int size = n * n;
+      int cellOf[256];
+      for (int pos = 0; pos < size; pos++) cellOf[(unsigned char)goal[pos]] = pos;
+      // Cell -> goal cell of the tile on it; a cycle of length k is k - 1 transpositions
+      std::vector<bool> seen(size, false);
+      int transpositions = 0;
+      for (int pos = 0; pos < size; pos++) {
+            if (seen[pos]) continue;
+            int length = 0;
+            for (int cell = pos; !seen[cell]; cell = cellOf[(unsigned char)start[cell]]) {
+                  seen[cell] = true;
+                  length++;
+            }
+            transpositions += length - 1;
+      }
+      int startBlank = start.find('#'), goalBlank = goal.find('#');
+      int blankDistance = std::abs(startBlank / n - goalBlank / n) + std::abs(startBlank % n - goalBlank % n);
+      return transpositions % 2 == blankDistance % 2;
+}
+
+/**
+ * @brief Goal cell of every tile character of goal (other characters: -1)
+ */
+inline std::vector<int> goalCells(const std::string& goal) {
+      std::vector<int> cells(256, -1);
+      for (size_t pos = 0; pos < goal.size(); pos++) cells[(unsigned char)goal[pos]] = pos;
+      return cells;
+}
+
+/**
+ * @brief Whether the blank of goal is in a corner, so relabelToCanonical() accepts it
+ */
+inline bool goalBlankInCorner(const std::string& goal, int n) {
+      int blank = goal.find('#');
+      return blank == 0 || blank == n - 1 || blank == n * (n - 1) || blank == n * n - 1;
+}
+
+/**
+ * @brief Rewrites start so that solving it towards canonical equals solving
+ *        the original start towards goal
+ * @param relabelled Output: the start board expressed for the canonical goal
+ * @return false if the boards use different tiles or the goal blank is not in a corner
+ */
+inline bool relabelToCanonical(const std::string& start, const std::string& goal,
+                               const std::string& canonical, int n, std::string& relabelled) {
+      int size = n * n;
+      if ((int)start.length() != size || (int)goal.length() != size || (int)canonical.length() != size) {
+            return false;
+      }
+
+      if (!sameTiles(start, goal, canonical)) return false;
+
+      // Symmetry that moves the goal blank onto the canonical blank cell
+      int goalBlank = goal.find('#');
+      int canonicalBlank = canonical.find('#');
+      int symmetry = -1;
+      for (int s = 0; s < 8 && symmetry < 0; s++) {
+            if (transformCell(goalBlank, n, s) == canonicalBlank) symmetry = s;
+      }
+      if (symmetry < 0) return false;
+
+      // Tile found at a cell of the transformed goal -> canonical tile of that cell
+      char label[256];
+      for (int pos = 0; pos < size; pos++) {
+            label[(unsigned char)goal[pos]] = canonical[transformCell(pos, n, symmetry)];
+      }
+
+      std::string result(size, '#');
+      for (int pos = 0; pos < size; pos++) {
+            result[transformCell(pos, n, symmetry)] = label[(unsigned char)start[pos]];
+      }
+      relabelled = result;  // start and relabelled may be the same string
+      return true;
+}
+
+#endif // GOAL_RELABEL_H
@@ -6,7 +6,14 @@
  * with h2 heuristic (sum of Manhattan distances).
  * 
  * Goal state: "ABCDEFGHIJKLMNO#"
- * Where '#' represents the empty space.
+ * Where '#' represents the empty space. A custom goal can be given as a
+ * second input token: any board with the same tiles (see goal_relabel.h).
+ * 
+ * Usage: h2_puzzle_solver [--engine astar|fringe] [--tie POLICY] [--stats] < "puzzle [goal]"
+ *   --engine fringe  Fringe Search instead of A* (fringe_search.h)
+ *   --tie POLICY     any, high-g, lifo or fifo: order among states with
+ *                    equal f(n) in A* (see tie_breaking.h)
+ *   --stats          Print the expanded-node count to stderr
  * 
  * @author JAPeTo
  * @version 1.6
@@ -17,12 +24,19 @@
 #include <unordered_map>
 #include <vector>
 #include <cmath>
+#include <cstring>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "goal_relabel.h"
+#include "tie_breaking.h"
+#include "fringe_search.h"
 
 using namespace std;
 
 const string TARGET = "ABCDEFGHIJKLMNO#";
-const int dRow[] = {-1, 1, 0, 0}; // UP, DOWN, LEFT, RIGHT
-const int dCol[] = {0, 0, -1, 1};
+string goalBoard = TARGET;  // TARGET or the custom goal of the input
+
+long long nodesExpanded = 0; // Statistics of the last A* search
 
 /**
  * @brief State structure for A* search
@@ -32,21 +46,19 @@ struct State {
       int blankPos;
       int cost;      // g(n) - actual cost from start
       int heuristic; // h(n) - estimated cost to goal
+      int pruneState; // Move-pruning automaton state (see move_pruning_table.h)
+      long long order; // Generation sequence number, for tie-breaking (see tie_breaking.h)
       
-      State(string b, int pos, int c, int h) : board(b), blankPos(pos), cost(c), heuristic(h) {}
+      State(string b, int pos, int c, int h, int ps = MOVE_PRUNING_START, long long o = 0) : board(b), blankPos(pos), cost(c), heuristic(h), pruneState(ps), order(o) {}
       
       // f(n) = g(n) + h(n)
       int f() const { return cost + heuristic; }
 };
 
 /**
- * @brief Comparator for priority queue (min-heap based on f(n))
+ * @brief Comparator for priority queue (min-heap on f(n), ties by policy)
  */
-struct CompareState {
-      bool operator()(const State& a, const State& b) const {
-            return a.f() > b.f(); // Min-heap: lower f(n) has higher priority
-      }
-};
+typedef TieBreakCompare<State> CompareState;
 
 /**
  * @brief Calculates h2 heuristic: sum of Manhattan distances
@@ -58,7 +70,7 @@ int calculateH2(const string& board) {
       for (int i = 0; i < 16; i++) {
             if (board[i] != '#') {
                   // Find goal position of this tile
-                  int goalPos = TARGET.find(board[i]);
+                  int goalPos = goalBoard.find(board[i]);
                   
                   // Convert positions to 2D coordinates
                   int currentRow = i / 4;
@@ -86,8 +98,8 @@ string swapTiles(const string& board, int pos1, int pos2) {
 /**
  * @brief A* search algorithm with h2 heuristic (Manhattan distance)
  */
-int aStarSearch(string start){
-      priority_queue<State, vector<State>, CompareState> pq;
+int aStarSearch(string start, TieBreakPolicy tiePolicy = TIE_ANY){
+      priority_queue<State, vector<State>, CompareState> pq((CompareState(tiePolicy)));
       unordered_set<string> visited;
       unordered_map<string, int> bestCost; // Track best cost to reach each state
       
@@ -95,39 +107,36 @@ int aStarSearch(string start){
       int h = calculateH2(start);
       pq.push(State(start, blankPos, 0, h));
       bestCost[start] = 0;
+      long long generated = 1;
       
       while (!pq.empty()) {
             State current = pq.top();
             pq.pop();
             
             // Check if goal state is reached
-            if (current.board == TARGET) return current.cost;
+            if (current.board == goalBoard) return current.cost;
             
             // Skip if we've already visited this state
             if (visited.count(current.board)) continue;
             visited.insert(current.board);
+            nodesExpanded++;
             
-            // Convert 1D position to 2D coordinates
-            int row = current.blankPos / 4;
-            int col = current.blankPos % 4;
-            
-            // Try all 4 possible moves
-            for (int i = 0; i < 4; i++) {
-                  int newRow = row + dRow[i];
-                  int newCol = col + dCol[i];
+            // Legal moves of the blank, precomputed per cell (successor_table.h)
+            const SuccessorTable& moves = SuccessorTable::square(4);
+            for (int k = 0; k < moves.count(current.blankPos); k++) {
+                  int i = moves.move(current.blankPos, k);
+                  // The path's pruning state rejects the inverse of its last move; the child's state goes into the queue with it
+                  int nextPruneState = MOVE_PRUNING_NEXT[current.pruneState][i];
+                  if (nextPruneState < 0) continue;
+                  int newPos = moves.neighbor(current.blankPos, k);
+                  string newBoard = swapTiles(current.board, current.blankPos, newPos);
+                  int newCost = current.cost + 1;
                   
-                  // Check if the move is within bounds
-                  if (newRow >= 0 && newRow < 4 && newCol >= 0 && newCol < 4) {
-                        int newPos = newRow * 4 + newCol;
-                        string newBoard = swapTiles(current.board, current.blankPos, newPos);
-                        int newCost = current.cost + 1;
-                        
-                        // Only add if we haven't found a better path to this state
-                        if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
-                              bestCost[newBoard] = newCost;
-                              int h = calculateH2(newBoard);
-                              pq.push(State(newBoard, newPos, newCost, h));
-                        }
+                  // Only add if we haven't found a better path to this state
+                  if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
+                        bestCost[newBoard] = newCost;
+                        int h = calculateH2(newBoard);
+                        pq.push(State(newBoard, newPos, newCost, h, nextPruneState, generated++));
                   }
             }
       }
@@ -136,10 +145,62 @@ int aStarSearch(string start){
       return -1;
 }
 
-int main(){
-      string start;
+int main(int argc, char* argv[]){
+      bool useFringe = false;
+      bool printStats = false;
+      TieBreakPolicy tiePolicy = TIE_ANY;
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+                  i++;
+                  if (strcmp(argv[i], "astar") != 0 && strcmp(argv[i], "fringe") != 0) {
+                        cerr << "Error: unknown engine " << argv[i] << endl;
+                        return 1;
+                  }
+                  useFringe = strcmp(argv[i], "fringe") == 0;
+            } else if (strcmp(argv[i], "--tie") == 0 && i + 1 < argc) {
+                  if (!parseTieBreakPolicy(argv[++i], tiePolicy)) {
+                        cerr << "Error: unknown tie-breaking policy " << argv[i] << endl;
+                        return 1;
+                  }
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            }
+      }
+
+      string start, goal;
       cin >> start;
-      int result = aStarSearch(start);
+
+      // Optional custom goal: searched for directly, the blank may be anywhere
+      if (cin >> goal) {
+            if (!sameTiles(start, goal, TARGET)) {
+                  cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                  return 1;
+            }
+            if (!goalReachable(start, goal, 4)) {
+                  cout << -1 << endl;
+                  return 0;
+            }
+            goalBoard = goal;
+      }
+
+      int result;
+      if (useFringe) {
+            FringeSearch fringe(4, goalBoard, calculateH2);
+            result = fringe.solve(start);
+            if (printStats) {
+                  cerr << "Engine: fringe" << endl;
+                  cerr << "Nodes expanded: " << fringe.expanded() << endl;
+                  cerr << "Iterations: " << fringe.iterations() << endl;
+                  cerr << "Stored nodes: " << fringe.storedNodes() << endl;
+            }
+      } else {
+            result = aStarSearch(start, tiePolicy);
+            if (printStats) {
+                  cerr << "Engine: astar" << endl;
+                  cerr << "Tie-breaking: " << tieBreakName(tiePolicy) << endl;
+                  cerr << "Nodes expanded: " << nodesExpanded << endl;
+            }
+      }
       cout << result << endl;
       return 0;
 }
\ No newline at end of file
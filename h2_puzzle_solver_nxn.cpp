@@ -11,7 +11,23 @@
  * 
  * Usage:
  *   h2_puzzle_solver_nxn <N> <initial_state>
+ *   Optional third argument (or second stdin token): custom goal board, any
+ *   board with the tiles of the generated target; the Manhattan tables are
+ *   built from its tile positions (see goal_relabel.h)
  *   Example: h2_puzzle_solver_nxn 4 ABCDEFG#IJKHMNOL
+ *   Options (anywhere): --engine astar|epea|fringe  A* (default), Enhanced
+ *                       Partial Expansion A* or Fringe Search (fringe_search.h);
+ *                       --tie any|high-g|lifo|fifo  order among equal-f states
+ *                       in A* and EPEA* (tie_breaking.h);
+ *                       --stats  expanded-node count to stderr
+ *
+ * EPEA* stores a node with the value F = f(n) + surplus and generates only
+ * the children whose f equals F, then re-queues the node with the next
+ * larger child f. A move changes Manhattan h by exactly +-1, so children have
+ * f(n) or f(n) + 2 and the f increase of a move depends only on the blank
+ * cell, the direction and the moved tile: one precomputed table (built by
+ * buildOperatorTable) selects the moves, and children with larger f are
+ * never built.
  * 
  * @author JAPeTo
  * @version 2.0 - Generic NxN support (Tarea No. 7)
@@ -23,7 +39,15 @@
 #include <unordered_map>
 #include <string>
 #include <algorithm>
+#include <climits>
 #include <chrono>
+#include <cstring>
+#include <vector>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "goal_relabel.h"
+#include "fringe_search.h"
+#include "tie_breaking.h"
 
 using namespace std;
 using namespace chrono;
@@ -35,9 +59,16 @@ using namespace chrono;
 int N = 4;  // Board size (NxN)
 string TARGET;  // Goal state
 unordered_map<char, int> targetPositions;  // Cache for target positions
+bool useFringe = false;   // --engine fringe
+bool useEpea = false;     // --engine epea
+bool printStats = false;  // --stats
+TieBreakPolicy tiePolicy = TIE_ANY;  // --tie
+long long nodesExpanded = 0;  // Statistics of the last A* search
+long long reexpansions = 0;   // EPEA*: partial expansions after the first
+long long statesStored = 0;   // Open-list pushes
+size_t peakOpen = 0;
+vector<int8_t> hDeltaTable;   // EPEA*: [(blank * 4 + move) * N * N + goal cell of the moved tile]
 
-const int dRow[] = {-1, 1, 0, 0};
-const int dCol[] = {0, 0, -1, 1};
 
 // =============================================================================
 // STATE STRUCTURE
@@ -48,11 +79,14 @@ struct State {
       int blankPos;
       int cost;      // g(n)
       int heuristic; // h(n)
+      int pruneState; // Move-pruning automaton state (see move_pruning_table.h)
+      long long order; // Generation sequence number, for tie-breaking (see tie_breaking.h)
+      int surplus;     // EPEA*: stored value F(n) - f(n), 0 until the first expansion
       
-      State(string b, int pos, int c, int h) 
-            : board(b), blankPos(pos), cost(c), heuristic(h) {}
+      State(string b, int pos, int c, int h, int ps = MOVE_PRUNING_START, long long o = 0, int s = 0) 
+            : board(b), blankPos(pos), cost(c), heuristic(h), pruneState(ps), order(o), surplus(s) {}
       
-      int f() const { return cost + heuristic; }
+      int f() const { return cost + heuristic + surplus; }
       
       bool operator>(const State& other) const {
             return f() > other.f();
@@ -92,6 +126,27 @@ void buildTargetPositions() {
       }
 }
 
+/**
+ * @brief EPEA* operator table: change of h when the blank moves from a cell in
+ *        a direction, for every goal cell of the tile that slides into it
+ */
+void buildOperatorTable() {
+      int cells = N * N;
+      hDeltaTable.assign(cells * 4 * cells, 0);
+      const SuccessorTable& moves = SuccessorTable::square(N);
+      for (int blank = 0; blank < cells; blank++) {
+            for (int k = 0; k < moves.count(blank); k++) {
+                  int move = moves.move(blank, k);
+                  int target = moves.neighbor(blank, k);
+                  for (int goalPos = 0; goalPos < cells; goalPos++) {
+                        int before = abs(target / N - goalPos / N) + abs(target % N - goalPos % N);
+                        int after = abs(blank / N - goalPos / N) + abs(blank % N - goalPos % N);
+                        hDeltaTable[(blank * 4 + move) * cells + goalPos] = after - before;
+                  }
+            }
+      }
+}
+
 /**
  * @brief Swaps two positions in the board
  */
@@ -139,7 +194,7 @@ int calculateH2(const string& board) {
  * @return Minimum number of moves, or -1 if unsolvable
  */
 int astar_h2(string start) {
-      priority_queue<State, vector<State>, greater<State>> pq;
+      priority_queue<State, vector<State>, TieBreakCompare<State>> pq((TieBreakCompare<State>(tiePolicy)));
       unordered_set<string> visited;
       unordered_map<string, int> bestCost;
       
@@ -149,9 +204,12 @@ int astar_h2(string start) {
       pq.push(State(start, blankPos, 0, h));
       bestCost[start] = 0;
       
-      int nodesExpanded = 0;
+      nodesExpanded = 0;
+      long long generated = 1;
+      peakOpen = 1;
       
       while (!pq.empty()) {
+            peakOpen = max(peakOpen, pq.size());
             State current = pq.top();
             pq.pop();
             
@@ -163,46 +221,170 @@ int astar_h2(string start) {
             
             // Check if goal state is reached
             if (current.board == TARGET) {
-                  //cerr << "Nodes expanded: " << nodesExpanded << endl;
+                  statesStored = generated;
                   return current.cost;
             }
             
-            // Convert 1D position to 2D coordinates (GENERIC)
-            int row = current.blankPos / N;
-            int col = current.blankPos % N;
+            // Legal moves of the blank, precomputed per cell (successor_table.h)
+            const SuccessorTable& moves = SuccessorTable::square(N);
+            for (int k = 0; k < moves.count(current.blankPos); k++) {
+                  int i = moves.move(current.blankPos, k);
+                  // Drops the inverse of the last move; the automaton works on directions, so one table serves every N
+                  int nextPruneState = MOVE_PRUNING_NEXT[current.pruneState][i];
+                  if (nextPruneState < 0) continue;
+                  int newPos = moves.neighbor(current.blankPos, k);
+                  string newBoard = swapTiles(current.board, current.blankPos, newPos);
+                  int newCost = current.cost + 1;
+                  
+                  // Only add if better cost
+                  if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
+                        bestCost[newBoard] = newCost;
+                        int h = calculateH2(newBoard);
+                        pq.push(State(newBoard, newPos, newCost, h, nextPruneState, generated++));
+                  }
+            }
+      }
+      
+      statesStored = generated;
+      return -1; // No solution found
+}
+
+/**
+ * @brief Enhanced Partial Expansion A* with Manhattan Distance
+ * @param start Initial board state
+ * @return Minimum number of moves, or -1 if unsolvable
+ */
+int epea_h2(string start) {
+      priority_queue<State, vector<State>, TieBreakCompare<State>> pq((TieBreakCompare<State>(tiePolicy)));
+      unordered_set<string> visited;
+      unordered_map<string, int> bestCost;
+      int cells = N * N;
+      
+      pq.push(State(start, start.find('#'), 0, calculateH2(start)));
+      bestCost[start] = 0;
+      
+      nodesExpanded = 0;
+      reexpansions = 0;
+      long long generated = 1;
+      peakOpen = 1;
+      
+      while (!pq.empty()) {
+            peakOpen = max(peakOpen, pq.size());
+            State current = pq.top();
+            pq.pop();
             
-            // Try all 4 possible moves
-            for (int i = 0; i < 4; i++) {
-                  int newRow = row + dRow[i];
-                  int newCol = col + dCol[i];
+            if (current.surplus == 0) {
+                  if (visited.count(current.board)) continue;
+                  visited.insert(current.board);
+                  nodesExpanded++;
+                  if (current.board == TARGET) {
+                        statesStored = generated;
+                        return current.cost;
+                  }
+            } else {
+                  // Re-queued after its first expansion: stale if a shorter path arrived since
+                  if (bestCost[current.board] < current.cost) continue;
+                  reexpansions++;
+            }
+            
+            const SuccessorTable& moves = SuccessorTable::square(N);
+            int nextSurplus = INT_MAX;
+            
+            for (int k = 0; k < moves.count(current.blankPos); k++) {
+                  int i = moves.move(current.blankPos, k);
+                  int nextPruneState = MOVE_PRUNING_NEXT[current.pruneState][i];
+                  if (nextPruneState < 0) continue;
+                  
+                  // f increase of this child, from the table alone
+                  int newPos = moves.neighbor(current.blankPos, k);
+                  int delta = hDeltaTable[(current.blankPos * 4 + i) * cells + targetPositions[current.board[newPos]]];
+                  int increase = 1 + delta;
+                  if (increase != current.surplus) {
+                        if (increase > current.surplus) nextSurplus = min(nextSurplus, increase);
+                        continue;
+                  }
                   
-                  // Validate bounds (GENERIC)
-                  if (newRow >= 0 && newRow < N && newCol >= 0 && newCol < N) {
-                        int newPos = newRow * N + newCol;
-                        string newBoard = swapTiles(current.board, current.blankPos, newPos);
-                        int newCost = current.cost + 1;
-                        
-                        // Only add if better cost
-                        if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
-                              bestCost[newBoard] = newCost;
-                              int h = calculateH2(newBoard);
-                              pq.push(State(newBoard, newPos, newCost, h));
-                        }
+                  string newBoard = swapTiles(current.board, current.blankPos, newPos);
+                  int newCost = current.cost + 1;
+                  if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
+                        bestCost[newBoard] = newCost;
+                        pq.push(State(newBoard, newPos, newCost, current.heuristic + delta, nextPruneState,
+                                      generated++));
                   }
             }
+            
+            // Children with larger f are left for later
+            if (nextSurplus != INT_MAX) {
+                  pq.push(State(current.board, current.blankPos, current.cost, current.heuristic,
+                                current.pruneState, generated++, nextSurplus));
+            }
       }
       
+      statesStored = generated;
       return -1; // No solution found
 }
 
+/**
+ * @brief Runs the selected engine and optionally prints its statistics
+ */
+int solve(const string& start) {
+      if (useFringe) {
+            FringeSearch fringe(N, TARGET, calculateH2);
+            int result = fringe.solve(start);
+            if (printStats) {
+                  cerr << "Engine: fringe" << endl;
+                  cerr << "Nodes expanded: " << fringe.expanded() << endl;
+                  cerr << "Iterations: " << fringe.iterations() << endl;
+                  cerr << "Stored nodes: " << fringe.storedNodes() << endl;
+            }
+            return result;
+      }
+      
+      int result = useEpea ? epea_h2(start) : astar_h2(start);
+      if (printStats) {
+            cerr << "Engine: " << (useEpea ? "epea" : "astar") << endl;
+            cerr << "Tie-breaking: " << tieBreakName(tiePolicy) << endl;
+            cerr << "Nodes expanded: " << nodesExpanded << endl;
+            if (useEpea) cerr << "Partial re-expansions: " << reexpansions << endl;
+            cerr << "Open-list pushes: " << statesStored << ", peak: " << peakOpen << endl;
+      }
+      return result;
+}
+
 // =============================================================================
 // MAIN FUNCTION
 // =============================================================================
 
 int main(int argc, char* argv[]) {
+      // Options may appear anywhere; the remaining arguments are positional
+      vector<char*> positional;
+      positional.push_back(argv[0]);
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+                  i++;
+                  if (strcmp(argv[i], "astar") != 0 && strcmp(argv[i], "epea") != 0 && strcmp(argv[i], "fringe") != 0) {
+                        cerr << "Error: unknown engine " << argv[i] << endl;
+                        return 1;
+                  }
+                  useFringe = strcmp(argv[i], "fringe") == 0;
+                  useEpea = strcmp(argv[i], "epea") == 0;
+            } else if (strcmp(argv[i], "--tie") == 0 && i + 1 < argc) {
+                  if (!parseTieBreakPolicy(argv[++i], tiePolicy)) {
+                        cerr << "Error: unknown tie-breaking policy " << argv[i] << endl;
+                        return 1;
+                  }
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            } else {
+                  positional.push_back(argv[i]);
+            }
+      }
+      argc = positional.size();
+      argv = positional.data();
+      
       if (argc < 2) {
             // Default mode: read from stdin for compatibility
-            string puzzle;
+            string puzzle, goal;
             cin >> puzzle;
             
             // Auto-detect board size
@@ -215,10 +397,25 @@ int main(int argc, char* argv[]) {
             else if (len == 64) N = 8;
             
             TARGET = generateTarget(N);
+            
+            // Optional custom goal: searched for directly, the blank may be anywhere
+            if (cin >> goal) {
+                  if (!sameTiles(puzzle, goal, TARGET)) {
+                        cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                        return 1;
+                  }
+                  if (!goalReachable(puzzle, goal, N)) {
+                        cout << -1 << endl;
+                        return 0;
+                  }
+                  TARGET = goal;
+            }
+            
             buildTargetPositions();
+            buildOperatorTable();
             
             auto startTime = high_resolution_clock::now();
-            int solution = astar_h2(puzzle);
+            int solution = solve(puzzle);
             auto endTime = high_resolution_clock::now();
             
             double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
@@ -226,8 +423,8 @@ int main(int argc, char* argv[]) {
             cout << solution << endl;
             //cerr << "Time: " << timeMs << " ms" << endl;
             
-      } else if (argc == 3) {
-            // New mode: specify board size
+      } else if (argc == 3 || argc == 4) {
+            // New mode: specify board size (and optionally a custom goal)
             N = atoi(argv[1]);
             string puzzle = argv[2];
             
@@ -242,7 +439,21 @@ int main(int argc, char* argv[]) {
             }
             
             TARGET = generateTarget(N);
+            
+            if (argc == 4) {
+                  if (!sameTiles(puzzle, argv[3], TARGET)) {
+                        cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                        return 1;
+                  }
+                  if (!goalReachable(puzzle, argv[3], N)) {
+                        cout << "This puzzle is NOT SOLVABLE" << endl;
+                        return 1;
+                  }
+                  TARGET = argv[3];
+            }
+            
             buildTargetPositions();
+            buildOperatorTable();
             
             cout << "========================================" << endl;
             cout << "A* Solver (h2) - " << N << "x" << N << " Puzzle" << endl;
@@ -250,10 +461,11 @@ int main(int argc, char* argv[]) {
             cout << "Initial: " << puzzle << endl;
             cout << "Target:  " << TARGET << endl;
             cout << "Heuristic: Manhattan Distance (h2)" << endl;
+            cout << "Engine: " << (useFringe ? "Fringe Search" : (useEpea ? "EPEA*" : "A*")) << endl;
             cout << "----------------------------------------" << endl;
             
             auto startTime = high_resolution_clock::now();
-            int solution = astar_h2(puzzle);
+            int solution = solve(puzzle);
             auto endTime = high_resolution_clock::now();
             
             double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
@@ -263,7 +475,7 @@ int main(int argc, char* argv[]) {
             cout << "========================================" << endl;
             
       } else {
-            cerr << "Usage: " << argv[0] << " [board_size] <puzzle>" << endl;
+            cerr << "Usage: " << argv[0] << " [board_size] <puzzle> [goal] [--engine astar|epea|fringe] [--tie POLICY] [--stats]" << endl;
             cerr << "  Mode 1 (auto-detect): echo \"ABCDEFG#IJKHMNOL\" | " << argv[0] << endl;
             cerr << "  Mode 2 (specify size): " << argv[0] << " 4 ABCDEFG#IJKHMNOL" << endl;
             cerr << endl;
@@ -0,0 +1,462 @@
+/**
+ * @file instance_generator.cpp
+ * @brief Deterministic, seeded instance corpora for NxN sliding puzzles
+ *
+ * Produces reproducible benchmark sets so that performance numbers of
+ * different builds are measured on exactly the same boards:
+ *
+ *   walk     Random-walk instances whose optimal depth is certified by an
+ *            embedded IDA* (Manhattan distance): a board is only emitted if
+ *            no solution shorter than the requested depth exists.
+ *   random   Uniformly random solvable permutations (Fisher-Yates shuffle,
+ *            unsolvable ones rejected with the parity test of isSolvable).
+ *            The optimal depth is certified only with --certify.
+ *   korf100  Converts the standard Korf-100 15-puzzle set (tile numbers,
+ *            0 = blank, goal with the blank top-left) to this repository's
+ *            board format, relabelled onto the canonical goal (goal_relabel.h)
+ *            so every solver accepts it without a custom goal.
+ *
+ * The random number generator is splitmix64 with its own range reduction
+ * (no std::uniform_int_distribution, whose output differs between standard
+ * libraries), so a seed produces the same corpus on every platform.
+ *
+ * Output: one instance per line, "board depth" ("?" when not certified).
+ * Boards use letters A.. and '#' for the blank, so N is limited to 2..5.
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -o instance_generator instance_generator.cpp
+ *
+ * Usage:
+ *   instance_generator walk <N> <count> <depth|min-max> [--seed S]
+ *   instance_generator random <N> <count> [--seed S] [--certify] [--max-nodes K]
+ *   instance_generator korf100 <file> [--certify] [--max-nodes K]
+ *
+ *   --seed S       Seed of the generator (default 1)
+ *   --certify      Compute the optimal depth of every instance (IDA*)
+ *   --max-nodes K  Give up certifying an instance after K nodes (prints "?")
+ *
+ * Examples:
+ *   instance_generator walk 4 10 20-30 --seed 7 > corpus_walk.txt
+ *   while read board depth; do echo "$board" | ./h2_puzzle_solver; done < corpus_walk.txt
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <unordered_set>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "goal_relabel.h"
+
+using namespace std;
+
+const int OPPOSITE[] = {1, 0, 3, 2};
+
+const int NOT_FOUND = -1;
+
+// =============================================================================
+// RANDOM NUMBERS
+// =============================================================================
+
+/**
+ * @brief splitmix64: same sequence for a given seed on every platform
+ */
+class SeededRandom {
+public:
+      explicit SeededRandom(uint64_t seed) : state(seed) {}
+
+      uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+      }
+
+      /**
+       * @brief Uniform integer in [0, bound) (rejection avoids modulo bias)
+       */
+      int below(int bound) {
+            uint64_t limit = UINT64_MAX - UINT64_MAX % bound;
+            uint64_t value;
+            do {
+                  value = next();
+            } while (value >= limit);
+            return value % bound;
+      }
+
+private:
+      uint64_t state;
+};
+
+// =============================================================================
+// BOARD HELPERS
+// =============================================================================
+
+/**
+ * @brief Canonical goal: A, B, C, ... with the blank in the last cell
+ */
+string generateTarget(int n) {
+      string target = "";
+      for (int i = 0; i < n * n - 1; i++) {
+            target += (char)('A' + i);
+      }
+      target += '#';
+      return target;
+}
+
+/**
+ * @brief Same parity test as isSolvable in bsp_puzzle_solver_nxn.cpp
+ */
+bool isSolvable(const string& board, int n) {
+      int inversions = 0;
+      int size = n * n;
+
+      for (int i = 0; i < size - 1; i++) {
+            if (board[i] == '#') continue;
+            for (int j = i + 1; j < size; j++) {
+                  if (board[j] == '#') continue;
+                  if (board[i] > board[j]) inversions++;
+            }
+      }
+
+      if (n % 2 == 1) {
+            return inversions % 2 == 0;
+      } else {
+            int blankRow = board.find('#') / n;
+            return (inversions + (n - blankRow)) % 2 == 1;
+      }
+}
+
+// =============================================================================
+// DEPTH CERTIFICATION (IDA* WITH MANHATTAN DISTANCE)
+// =============================================================================
+
+/**
+ * @brief Optimal solver used to certify the depth of generated instances
+ */
+class DepthCertifier {
+public:
+      DepthCertifier(int size, long long nodeLimit) : n(size), maxNodes(nodeLimit), nodes(0) {
+            string target = generateTarget(n);
+            memset(goalPos, 0, sizeof(goalPos));
+            for (int i = 0; i < n * n; i++) goalPos[(unsigned char)target[i]] = i;
+      }
+
+      /**
+       * @brief Optimal number of moves, or NOT_FOUND if it exceeds maxDepth
+       *        or the node limit was reached (see limitReached)
+       */
+      int solve(const string& start, int maxDepth = INT_MAX) {
+            board = start;
+            nodes = 0;
+            limitHit = false;
+            int blank = board.find('#');
+            int threshold = manhattan();
+
+            while (threshold <= maxDepth) {
+                  int next = search(blank, 0, manhattan(), threshold, MOVE_PRUNING_START);
+                  if (next == FOUND) return threshold;
+                  if (limitHit || next == INT_MAX) return NOT_FOUND;
+                  threshold = next;
+            }
+            return NOT_FOUND;
+      }
+
+      bool limitReached() const { return limitHit; }
+
+private:
+      static const int FOUND = -1;
+
+      int manhattan() const {
+            int distance = 0;
+            for (int i = 0; i < n * n; i++) {
+                  if (board[i] == '#') continue;
+                  distance += tileDistance(board[i], i);
+            }
+            return distance;
+      }
+
+      int tileDistance(char tile, int pos) const {
+            int goal = goalPos[(unsigned char)tile];
+            return abs(pos / n - goal / n) + abs(pos % n - goal % n);
+      }
+
+      int search(int blank, int cost, int heuristic, int threshold, int pruneState) {
+            int f = cost + heuristic;
+            if (f > threshold) return f;
+            if (heuristic == 0) return FOUND;
+            if (maxNodes > 0 && ++nodes > maxNodes) {
+                  limitHit = true;
+                  return INT_MAX;
+            }
+
+            int minimum = INT_MAX;
+            const SuccessorTable& moves = SuccessorTable::square(n);
+            for (int k = 0; k < moves.count(blank); k++) {
+                  int nextState = MOVE_PRUNING_NEXT[pruneState][moves.move(blank, k)];
+                  if (nextState < 0) continue;
+
+                  int newBlank = moves.neighbor(blank, k);
+                  char tile = board[newBlank];
+                  int newHeuristic = heuristic - tileDistance(tile, newBlank) + tileDistance(tile, blank);
+                  swap(board[blank], board[newBlank]);
+                  int result = search(newBlank, cost + 1, newHeuristic, threshold, nextState);
+                  swap(board[blank], board[newBlank]);
+
+                  if (result == FOUND) return FOUND;
+                  if (limitHit) return INT_MAX;
+                  if (result < minimum) minimum = result;
+            }
+            return minimum;
+      }
+
+      int n;
+      long long maxNodes;
+      long long nodes;
+      bool limitHit;
+      string board;
+      int goalPos[256];
+};
+
+// =============================================================================
+// GENERATORS
+// =============================================================================
+
+/**
+ * @brief Random-walk instances whose optimal depth is exactly the target
+ *
+ * One walk (never undoing the previous move) is extended until a board with
+ * the parity of the target depth and Manhattan distance <= target appears
+ * after at least `depth` moves; IDA* limited to `depth` then decides whether
+ * it is really `depth` moves away. Walks that drift too far are restarted.
+ * @return false if not enough distinct boards were found at that depth
+ */
+bool generateWalks(int n, int count, int depth, SeededRandom& rng,
+                   unordered_set<string>& emitted, DepthCertifier& certifier) {
+      const string target = generateTarget(n);
+      const int maxSteps = 4 * depth + 20;
+      const int maxWalks = 100000;  // Depth out of reach or too few boards at it
+      const SuccessorTable& table = SuccessorTable::square(n);
+      int produced = 0;
+
+      for (int walk = 0; produced < count; walk++) {
+            if (walk == maxWalks) return false;
+
+            string board = target;
+            int blank = n * n - 1;
+            int lastMove = -1;
+
+            for (int step = 1; step <= maxSteps; step++) {
+                  int moves[4], options = 0;
+                  for (int k = 0; k < table.count(blank); k++) {
+                        int move = table.move(blank, k);
+                        if (lastMove >= 0 && move == OPPOSITE[lastMove]) continue;
+                        moves[options++] = move;
+                  }
+                  int move = moves[rng.below(options)];
+                  int newBlank = table.target(blank, move);
+                  swap(board[blank], board[newBlank]);
+                  blank = newBlank;
+                  lastMove = move;
+
+                  if (step < depth || (step - depth) % 2 != 0) continue;
+                  if (emitted.count(board)) continue;
+                  if (certifier.solve(board, depth) != depth) continue;
+
+                  emitted.insert(board);
+                  cout << board << " " << depth << endl;
+                  produced++;
+                  break;
+            }
+      }
+      return true;
+}
+
+/**
+ * @brief Uniformly random solvable boards (rejection keeps the distribution uniform)
+ */
+void generateRandom(int n, int count, SeededRandom& rng, bool certify, DepthCertifier& certifier) {
+      string board = generateTarget(n);
+      for (int produced = 0; produced < count; ) {
+            for (int i = n * n - 1; i > 0; i--) {
+                  swap(board[i], board[rng.below(i + 1)]);
+            }
+            if (!isSolvable(board, n)) continue;
+
+            cout << board << " ";
+            int depth = certify ? certifier.solve(board) : NOT_FOUND;
+            if (depth == NOT_FOUND) cout << "?" << endl;
+            else cout << depth << endl;
+            produced++;
+      }
+}
+
+/**
+ * @brief Reads "[index] t0 ... t15 [optimal]" lines (0 = blank) of the Korf-100 set
+ */
+int convertKorf(const string& path, bool certify, DepthCertifier& certifier) {
+      ifstream in(path.c_str());
+      if (!in) {
+            cerr << "Error: cannot open " << path << endl;
+            return 1;
+      }
+
+      const string target = generateTarget(4);
+      const string korfGoal = "#" + target.substr(0, 15);  // blank top-left, then 1..15
+      string line;
+      int lineNumber = 0, converted = 0;
+
+      while (getline(in, line)) {
+            lineNumber++;
+            if (line.empty() || line[0] == '#') continue;
+
+            vector<int> values;
+            istringstream tokens(line);
+            int value;
+            while (tokens >> value) values.push_back(value);
+            if (values.size() < 16 || values.size() > 18) {
+                  cerr << "Error: line " << lineNumber << " does not hold 16 tiles" << endl;
+                  return 1;
+            }
+
+            // A leading index is present when skipping it leaves a permutation of 0..15
+            size_t first = 0;
+            if (values.size() > 16) {
+                  unsigned seen = 0;
+                  for (size_t i = 1; i < 17 && i < values.size(); i++) {
+                        if (values[i] >= 0 && values[i] < 16) seen |= 1u << values[i];
+                  }
+                  if (values.size() == 18 || seen == 0xFFFF) first = 1;
+            }
+            int known = values.size() > first + 16 ? values[first + 16] : NOT_FOUND;
+
+            string board(16, '#');
+            unsigned seen = 0;
+            for (int i = 0; i < 16; i++) {
+                  int tile = values[first + i];
+                  if (tile < 0 || tile > 15 || (seen & (1u << tile))) {
+                        cerr << "Error: line " << lineNumber << " is not a permutation of 0..15" << endl;
+                        return 1;
+                  }
+                  seen |= 1u << tile;
+                  board[i] = tile == 0 ? '#' : (char)('A' + tile - 1);
+            }
+
+            string canonical;
+            relabelToCanonical(board, korfGoal, target, 4, canonical);
+            if (!isSolvable(canonical, 4)) {
+                  cerr << "Error: line " << lineNumber << " is not solvable" << endl;
+                  return 1;
+            }
+
+            int depth = certify ? certifier.solve(canonical) : NOT_FOUND;
+            if (depth != NOT_FOUND && known != NOT_FOUND && depth != known) {
+                  cerr << "Warning: line " << lineNumber << " lists " << known
+                       << " moves, certified " << depth << endl;
+            }
+            if (depth == NOT_FOUND) depth = known;
+
+            cout << canonical << " ";
+            if (depth == NOT_FOUND) cout << "?" << endl;
+            else cout << depth << endl;
+            converted++;
+      }
+
+      if (converted != 100) {
+            cerr << "Warning: " << converted << " instances read, the Korf-100 set has 100" << endl;
+      }
+      return 0;
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+void printUsage(const char* program) {
+      cerr << "Usage:" << endl;
+      cerr << "  " << program << " walk <N> <count> <depth|min-max> [--seed S]" << endl;
+      cerr << "  " << program << " random <N> <count> [--seed S] [--certify] [--max-nodes K]" << endl;
+      cerr << "  " << program << " korf100 <file> [--certify] [--max-nodes K]" << endl;
+}
+
+int main(int argc, char* argv[]) {
+      uint64_t seed = 1;
+      bool certify = false;
+      long long maxNodes = 0;
+      vector<string> positional;
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                  seed = strtoull(argv[++i], nullptr, 10);
+            } else if (strcmp(argv[i], "--certify") == 0) {
+                  certify = true;
+            } else if (strcmp(argv[i], "--max-nodes") == 0 && i + 1 < argc) {
+                  maxNodes = atoll(argv[++i]);
+            } else {
+                  positional.push_back(argv[i]);
+            }
+      }
+
+      if (positional.size() == 2 && positional[0] == "korf100") {
+            DepthCertifier certifier(4, maxNodes);
+            return convertKorf(positional[1], certify, certifier);
+      }
+
+      if (positional.size() < 3) {
+            printUsage(argv[0]);
+            return 1;
+      }
+
+      string mode = positional[0];
+      int n = atoi(positional[1].c_str());
+      int count = atoi(positional[2].c_str());
+      if (n < 2 || n > 5) {
+            cerr << "Error: Board size must be between 2 and 5" << endl;
+            return 1;
+      }
+      if (count < 1) {
+            cerr << "Error: count must be positive" << endl;
+            return 1;
+      }
+
+      SeededRandom rng(seed);
+      DepthCertifier certifier(n, maxNodes);
+
+      if (mode == "walk" && positional.size() == 4) {
+            int minDepth = 0, maxDepth = 0;
+            size_t dash = positional[3].find('-');
+            minDepth = atoi(positional[3].substr(0, dash).c_str());
+            maxDepth = dash == string::npos ? minDepth : atoi(positional[3].substr(dash + 1).c_str());
+            if (minDepth < 1 || maxDepth < minDepth) {
+                  cerr << "Error: invalid depth range " << positional[3] << endl;
+                  return 1;
+            }
+
+            cerr << "walk N=" << n << " depth=" << minDepth << "-" << maxDepth
+                 << " count=" << count << " seed=" << seed << endl;
+            unordered_set<string> emitted;
+            for (int depth = minDepth; depth <= maxDepth; depth++) {
+                  if (!generateWalks(n, count, depth, rng, emitted, certifier)) {
+                        cerr << "Error: could not find " << count << " boards at depth " << depth << endl;
+                        return 1;
+                  }
+            }
+      } else if (mode == "random" && positional.size() == 3) {
+            cerr << "random N=" << n << " count=" << count << " seed=" << seed << endl;
+            generateRandom(n, count, rng, certify, certifier);
+      } else {
+            printUsage(argv[0]);
+            return 1;
+      }
+
+      return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * @file move_pruning_generator.cpp
+ * @brief Offline generator for the move-pruning automaton (FSM pruning)
+ *
+ * Enumerates every blank move sequence up to a maximum length on an open board
+ * (large enough that no sequence touches a border) and records which sequences
+ * are redundant: a sequence is redundant when an earlier sequence in
+ * (length, lexicographic) order reaches exactly the same board. The minimal
+ * redundant sequences (inverse pairs, short cycles...) are compiled into an
+ * Aho-Corasick automaton over the alphabet {UP, DOWN, LEFT, RIGHT}.
+ *
+ * The solvers keep one automaton state per search node and skip every move
+ * whose transition is marked as pruned, so duplicates are never generated
+ * instead of being discarded later through hash lookups.
+ *
+ * Note: sliding-tile moves never commute, so besides the inverse pairs the
+ * redundancies are equal-length transpositions around 2x2 blocks (first ones
+ * at length 6, e.g. LURDLU). Pruning sequences longer than 2 is only safe for
+ * tree search (IDA*); graph searches with duplicate detection must use the
+ * default table (max length 2).
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -o move_pruning_generator move_pruning_generator.cpp
+ *
+ * Usage:
+ *   move_pruning_generator [max_length] > move_pruning_table.h
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <queue>
+#include <unordered_map>
+#include <cstdlib>
+#include "successor_table.h"
+
+using namespace std;
+
+const char MOVE_CHARS[] = {'U', 'D', 'L', 'R'}; // UP, DOWN, LEFT, RIGHT
+
+// =============================================================================
+// SEQUENCE ENUMERATION
+// =============================================================================
+
+/**
+ * @brief Applies a move sequence to the open board and returns a compact key
+ *
+ * Only tiles that left their initial cell are encoded, so the key stays short
+ * regardless of the board width.
+ */
+string sequenceKey(const string& sequence, int width) {
+      vector<int> board(width * width);
+      for (int i = 0; i < width * width; i++) board[i] = i;
+
+      int blankPos = (width / 2) * width + width / 2;
+      for (char m : sequence) {
+            int move = m - '0';
+            int newPos = successorTarget(width, width, blankPos, move);
+            swap(board[blankPos], board[newPos]);
+            blankPos = newPos;
+      }
+
+      string key;
+      for (int i = 0; i < width * width; i++) {
+            if (board[i] != i) {
+                  key += to_string(i) + ":" + to_string(board[i]) + ",";
+            }
+      }
+      return key;
+}
+
+/**
+ * @brief Returns true if any suffix of the sequence is already forbidden
+ */
+bool hasForbiddenSuffix(const string& sequence, const set<string>& forbidden) {
+      for (size_t i = 0; i < sequence.size(); i++) {
+            if (forbidden.count(sequence.substr(i))) return true;
+      }
+      return false;
+}
+
+/**
+ * @brief Finds the minimal redundant move sequences up to maxLength
+ *
+ * Sequences are visited in (length, lexicographic) order; the first one that
+ * reaches a board is canonical and every later one reaching it is redundant.
+ */
+set<string> findRedundantSequences(int maxLength) {
+      int width = 2 * maxLength + 1;
+      set<string> forbidden;
+      unordered_map<string, string> firstSequence;
+
+      vector<string> currentLevel(1, "");
+      firstSequence[sequenceKey("", width)] = "";
+
+      for (int length = 1; length <= maxLength; length++) {
+            vector<string> nextLevel;
+            for (const string& prefix : currentLevel) {
+                  for (int m = 0; m < 4; m++) {
+                        string sequence = prefix + (char)('0' + m);
+                        if (hasForbiddenSuffix(sequence, forbidden)) continue;
+
+                        string key = sequenceKey(sequence, width);
+                        if (firstSequence.count(key)) {
+                              forbidden.insert(sequence);
+                        } else {
+                              firstSequence[key] = sequence;
+                              nextLevel.push_back(sequence);
+                        }
+                  }
+            }
+            currentLevel.swap(nextLevel);
+      }
+
+      return forbidden;
+}
+
+// =============================================================================
+// AUTOMATON CONSTRUCTION
+// =============================================================================
+
+/**
+ * @brief Compiles forbidden sequences into a dense transition table
+ *
+ * Builds the Aho-Corasick automaton of the forbidden set. Terminal nodes are
+ * removed: a transition that would enter one becomes -1 (pruned), and the
+ * remaining nodes are renumbered so that state 0 is the start state.
+ */
+vector<vector<int>> buildAutomaton(const set<string>& forbidden) {
+      vector<vector<int>> go(1, vector<int>(4, -1));
+      vector<bool> terminal(1, false);
+
+      for (const string& sequence : forbidden) {
+            int node = 0;
+            for (char c : sequence) {
+                  int m = c - '0';
+                  if (go[node][m] < 0) {
+                        go[node][m] = go.size();
+                        go.push_back(vector<int>(4, -1));
+                        terminal.push_back(false);
+                  }
+                  node = go[node][m];
+            }
+            terminal[node] = true;
+      }
+
+      // Failure links (breadth-first), completing the goto function
+      vector<int> fail(go.size(), 0);
+      queue<int> q;
+      for (int m = 0; m < 4; m++) {
+            if (go[0][m] < 0) {
+                  go[0][m] = 0;
+            } else {
+                  fail[go[0][m]] = 0;
+                  q.push(go[0][m]);
+            }
+      }
+      while (!q.empty()) {
+            int node = q.front();
+            q.pop();
+            if (terminal[fail[node]]) terminal[node] = true;
+            for (int m = 0; m < 4; m++) {
+                  int child = go[node][m];
+                  if (child < 0) {
+                        go[node][m] = go[fail[node]][m];
+                  } else {
+                        fail[child] = go[fail[node]][m];
+                        q.push(child);
+                  }
+            }
+      }
+
+      // Renumber non-terminal states, start state first
+      vector<int> index(go.size(), -1);
+      int numStates = 0;
+      for (int node = 0; node < (int)go.size(); node++) {
+            if (!terminal[node]) index[node] = numStates++;
+      }
+
+      vector<vector<int>> table(numStates, vector<int>(4, -1));
+      for (int node = 0; node < (int)go.size(); node++) {
+            if (terminal[node]) continue;
+            for (int m = 0; m < 4; m++) {
+                  table[index[node]][m] = index[go[node][m]];
+            }
+      }
+      return table;
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+
+void printHeader(const vector<vector<int>>& table, const set<string>& forbidden, int maxLength) {
+      cout << "/**" << endl;
+      cout << " * @file move_pruning_table.h" << endl;
+      cout << " * @brief Move-pruning automaton for sliding-tile search (generated)" << endl;
+      cout << " * " << endl;
+      cout << " * Generated by move_pruning_generator.cpp with max length " << maxLength << "." << endl;
+      cout << " * Do not edit by hand; regenerate with:" << endl;
+      cout << " *   move_pruning_generator " << maxLength << " > move_pruning_table.h" << endl;
+      cout << " * " << endl;
+      cout << " * Redundant sequences (" << forbidden.size() << "):";
+      int printed = 0;
+      for (const string& sequence : forbidden) {
+            if (printed % 8 == 0) cout << endl << " *  ";
+            cout << " ";
+            for (char c : sequence) cout << MOVE_CHARS[c - '0'];
+            printed++;
+      }
+      cout << endl;
+      cout << " * " << endl;
+      cout << " * Moves are indexed as dRow/dCol: 0=UP, 1=DOWN, 2=LEFT, 3=RIGHT." << endl;
+      cout << " * MOVE_PRUNING_NEXT[state][move] is the successor state, or -1 when" << endl;
+      cout << " * the move completes a redundant sequence and must not be generated." << endl;
+      cout << " */" << endl;
+      cout << endl;
+      cout << "#ifndef MOVE_PRUNING_TABLE_H" << endl;
+      cout << "#define MOVE_PRUNING_TABLE_H" << endl;
+      cout << endl;
+      cout << "const int MOVE_PRUNING_MAX_LENGTH = " << maxLength << ";" << endl;
+      cout << "const int MOVE_PRUNING_STATES = " << table.size() << ";" << endl;
+      cout << "const int MOVE_PRUNING_START = 0;" << endl;
+      cout << endl;
+      cout << "const int MOVE_PRUNING_NEXT[" << table.size() << "][4] = {" << endl;
+      for (int s = 0; s < (int)table.size(); s++) {
+            cout << "      {";
+            for (int m = 0; m < 4; m++) {
+                  cout << table[s][m];
+                  if (m < 3) cout << ", ";
+            }
+            cout << "}";
+            if (s + 1 < (int)table.size()) cout << ",";
+            cout << endl;
+      }
+      cout << "};" << endl;
+      cout << endl;
+      cout << "#endif // MOVE_PRUNING_TABLE_H" << endl;
+}
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+int main(int argc, char* argv[]) {
+      int maxLength = (argc >= 2) ? atoi(argv[1]) : 2;
+
+      if (maxLength < 2 || maxLength > 14) {
+            cerr << "Error: max_length must be between 2 and 14" << endl;
+            return 1;
+      }
+
+      set<string> forbidden = findRedundantSequences(maxLength);
+      vector<vector<int>> table = buildAutomaton(forbidden);
+
+      cerr << "Redundant sequences: " << forbidden.size() << endl;
+      cerr << "Automaton states: " << table.size() << endl;
+
+      printHeader(table, forbidden, maxLength);
+      return 0;
+}
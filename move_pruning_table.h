@@ -0,0 +1,32 @@
+/**
+ * @file move_pruning_table.h
+ * @brief Move-pruning automaton for sliding-tile search (generated)
+ * 
+ * Generated by move_pruning_generator.cpp with max length 2.
+ * Do not edit by hand; regenerate with:
+ *   move_pruning_generator 2 > move_pruning_table.h
+ * 
+ * Redundant sequences (4):
+ *   UD DU LR RL
+ * 
+ * Moves are indexed as dRow/dCol: 0=UP, 1=DOWN, 2=LEFT, 3=RIGHT.
+ * MOVE_PRUNING_NEXT[state][move] is the successor state, or -1 when
+ * the move completes a redundant sequence and must not be generated.
+ */
+
+#ifndef MOVE_PRUNING_TABLE_H
+#define MOVE_PRUNING_TABLE_H
+
+const int MOVE_PRUNING_MAX_LENGTH = 2;
+const int MOVE_PRUNING_STATES = 5;
+const int MOVE_PRUNING_START = 0;
+
+const int MOVE_PRUNING_NEXT[5][4] = {
+      {1, 2, 3, 4},
+      {1, -1, 3, 4},
+      {-1, 2, 3, 4},
+      {1, 2, 3, -1},
+      {1, 2, -1, 4}
+};
+
+#endif // MOVE_PRUNING_TABLE_H
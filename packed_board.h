@@ -0,0 +1,76 @@
+/**
+ * @file packed_board.h
+ * @brief 64-bit packed representation for boards of up to 16 cells
+ *
+ * Each cell is stored in one nibble (cell i in bits 4i..4i+3). Tiles 'A'..'O'
+ * are stored as 0..14 and the blank '#' as 15, so a 4x4 board fits exactly
+ * in one uint64_t and can be used directly as a hash key.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef PACKED_BOARD_H
+#define PACKED_BOARD_H
+
+#include <cstdint>
+#include <string>
+
+typedef uint64_t PackedBoard;
+
+const int PACKED_BLANK = 15;
+
+/**
+ * @brief Packs a board string ("ABCDEFGHIJKLMNO#") into 64 bits
+ */
+inline PackedBoard packBoard(const std::string& board) {
+      PackedBoard packed = 0;
+      for (int i = 0; i < (int)board.length(); i++) {
+            uint64_t tile = (board[i] == '#') ? PACKED_BLANK : (uint64_t)(board[i] - 'A');
+            packed |= tile << (4 * i);
+      }
+      return packed;
+}
+
+/**
+ * @brief Unpacks a 64-bit board back into its string form
+ * @param size Number of cells (16 for the 4x4 board)
+ */
+inline std::string unpackBoard(PackedBoard packed, int size = 16) {
+      std::string board(size, '#');
+      for (int i = 0; i < size; i++) {
+            int tile = (packed >> (4 * i)) & 0xF;
+            if (tile != PACKED_BLANK) board[i] = (char)('A' + tile);
+      }
+      return board;
+}
+
+/**
+ * @brief Returns the tile stored at a position
+ */
+inline int packedTile(PackedBoard packed, int pos) {
+      return (packed >> (4 * pos)) & 0xF;
+}
+
+/**
+ * @brief Slides the tile at newPos into the blank at blankPos
+ */
+inline PackedBoard packedMove(PackedBoard packed, int blankPos, int newPos) {
+      uint64_t tile = (packed >> (4 * newPos)) & 0xF;
+      packed &= ~((uint64_t)0xF << (4 * blankPos));
+      packed |= tile << (4 * blankPos);
+      packed |= (uint64_t)PACKED_BLANK << (4 * newPos);
+      return packed;
+}
+
+/**
+ * @brief Finds the blank position of a packed board
+ */
+inline int packedBlankPos(PackedBoard packed, int size = 16) {
+      for (int i = 0; i < size; i++) {
+            if (packedTile(packed, i) == PACKED_BLANK) return i;
+      }
+      return -1;
+}
+
+#endif // PACKED_BOARD_H
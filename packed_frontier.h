@@ -0,0 +1,232 @@
+/**
+ * @file packed_frontier.h
+ * @brief Compact BFS layer: packed 4x4 boards stored in blocks
+ *
+ * A layer of a level-synchronous BFS only needs the boards: the level is the
+ * same for every entry and the blank position can be recovered from the
+ * board. Each entry is therefore one 64-bit packed board (packed_board.h)
+ * instead of a State with a heap-allocated string.
+ *
+ * Every entry can also carry a small tag (below tagValues, given to the
+ * constructor): the BFS stores the move-pruning state of the path that
+ * reached the board, which the board itself cannot tell. Uncompressed blocks
+ * keep the tags in a byte array beside the boards.
+ *
+ * Optionally every block is compressed: the boards are replaced by their
+ * permutation rank (16! < 2^45), combined with the tag as
+ * rank * tagValues + tag, sorted, and stored as LEB128-encoded gaps between
+ * consecutive keys. Large blocks keep the gaps small, so a board takes 2-4
+ * bytes instead of 8, and a tag of 5 values adds about 2.3 bits.
+ *
+ * Parallel append: threads fill a private buffer and hand it over once it
+ * holds BLOCK_KEYS boards (and at the end); encoding happens outside the
+ * lock, which only guards pushing the finished block. Parallel iteration:
+ * blocks are independent, so threads read different blocks concurrently.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef PACKED_FRONTIER_H
+#define PACKED_FRONTIER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "packed_board.h"
+
+class PackedFrontier {
+public:
+      static const size_t BLOCK_KEYS = 1 << 16;
+
+      explicit PackedFrontier(bool compressBlocks = false, unsigned tagValues = 1)
+            : compressed(compressBlocks), tagCount(std::max(1u, tagValues)), count(0) {}
+
+      /**
+       * @brief Moves a batch of boards into the frontier with tag 0 (thread-safe);
+       *        batch is left empty
+       */
+      void append(std::vector<PackedBoard>& batch) {
+            std::vector<uint8_t> noTags;
+            append(batch, noTags);
+      }
+
+      /**
+       * @brief Moves a batch of boards and their tags into the frontier
+       *        (thread-safe); both vectors are left empty
+       * @param tags One tag below tagValues per board, or empty for all 0
+       */
+      void append(std::vector<PackedBoard>& batch, std::vector<uint8_t>& tags) {
+            if (batch.empty()) return;
+            if (tagCount > 1) tags.resize(batch.size(), 0);
+            Block block;
+            block.count = batch.size();
+            if (compressed) {
+                  encode(batch, tags, block.encoded);
+                  batch.clear();
+            } else {
+                  block.raw.swap(batch);
+                  if (tagCount > 1) block.tags.swap(tags);
+            }
+            tags.clear();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            count += block.count;
+            blocks.push_back(Block());
+            blocks.back().swap(block);
+      }
+
+      size_t blockCount() const { return blocks.size(); }
+
+      /**
+       * @brief Decodes the boards of one block (safe to call from several threads at once)
+       */
+      void readBlock(size_t b, std::vector<PackedBoard>& out) const {
+            std::vector<uint8_t> tags;
+            readBlock(b, out, tags);
+      }
+
+      /**
+       * @brief Decodes the boards of one block and their tags
+       */
+      void readBlock(size_t b, std::vector<PackedBoard>& out, std::vector<uint8_t>& tags) const {
+            const Block& block = blocks[b];
+            if (!compressed) {
+                  out.assign(block.raw.begin(), block.raw.end());
+                  if (block.tags.empty()) tags.assign(block.count, 0);
+                  else tags.assign(block.tags.begin(), block.tags.end());
+                  return;
+            }
+            out.clear();
+            out.reserve(block.count);
+            tags.clear();
+            tags.reserve(block.count);
+            const uint8_t* data = block.encoded.data();
+            uint64_t key = 0;
+            for (size_t i = 0; i < block.count; i++) {
+                  key += readVarint(data);
+                  out.push_back(unrank(key / tagCount));
+                  tags.push_back((uint8_t)(key % tagCount));
+            }
+      }
+
+      size_t size() const { return count; }
+
+      bool empty() const { return count == 0; }
+
+      /**
+       * @brief Bytes held by the stored boards (excluding container overhead)
+       */
+      size_t bytes() const {
+            size_t total = 0;
+            for (size_t b = 0; b < blocks.size(); b++) {
+                  total += compressed ? blocks[b].encoded.size()
+                                      : blocks[b].raw.size() * sizeof(PackedBoard) + blocks[b].tags.size();
+            }
+            return total;
+      }
+
+      void clear() {
+            blocks.clear();
+            count = 0;
+      }
+
+      void swap(PackedFrontier& other) {
+            blocks.swap(other.blocks);
+            std::swap(count, other.count);
+            std::swap(compressed, other.compressed);
+            std::swap(tagCount, other.tagCount);
+      }
+
+      /**
+       * @brief Lexicographic rank of a 4x4 board among the 16! permutations
+       */
+      static uint64_t rank(PackedBoard board) {
+            uint64_t result = 0;
+            unsigned unused = 0xFFFF;
+            for (int pos = 0; pos < 16; pos++) {
+                  int tile = packedTile(board, pos);
+                  result = result * (16 - pos) + __builtin_popcount(unused & ((1u << tile) - 1));
+                  unused &= ~(1u << tile);
+            }
+            return result;
+      }
+
+      static PackedBoard unrank(uint64_t rank) {
+            int digits[16];
+            for (int pos = 15; pos >= 0; pos--) {
+                  digits[pos] = rank % (16 - pos);
+                  rank /= (16 - pos);
+            }
+            PackedBoard board = 0;
+            unsigned unused = 0xFFFF;
+            for (int pos = 0; pos < 16; pos++) {
+                  unsigned bits = unused;
+                  for (int skip = 0; skip < digits[pos]; skip++) bits &= bits - 1;
+                  int tile = __builtin_ctz(bits);
+                  unused &= ~(1u << tile);
+                  board |= (PackedBoard)tile << (4 * pos);
+            }
+            return board;
+      }
+
+private:
+      struct Block {
+            size_t count;
+            std::vector<PackedBoard> raw;   // uncompressed mode
+            std::vector<uint8_t> tags;      // uncompressed mode with tagValues > 1
+            std::vector<uint8_t> encoded;   // compressed mode: sorted rank gaps
+
+            Block() : count(0) {}
+
+            void swap(Block& other) {
+                  std::swap(count, other.count);
+                  raw.swap(other.raw);
+                  tags.swap(other.tags);
+                  encoded.swap(other.encoded);
+            }
+      };
+
+      void encode(const std::vector<PackedBoard>& batch, const std::vector<uint8_t>& tags,
+                  std::vector<uint8_t>& out) const {
+            std::vector<uint64_t> keys(batch.size());
+            for (size_t i = 0; i < batch.size(); i++) {
+                  keys[i] = rank(batch[i]) * tagCount + (tags.empty() ? 0 : tags[i]);
+            }
+            std::sort(keys.begin(), keys.end());
+
+            out.clear();
+            out.reserve(batch.size() * 4);
+            uint64_t previous = 0;
+            for (size_t i = 0; i < keys.size(); i++) {
+                  uint64_t gap = keys[i] - previous;
+                  previous = keys[i];
+                  while (gap >= 0x80) {
+                        out.push_back((uint8_t)(gap | 0x80));
+                        gap >>= 7;
+                  }
+                  out.push_back((uint8_t)gap);
+            }
+            out.shrink_to_fit();
+      }
+
+      static uint64_t readVarint(const uint8_t*& data) {
+            uint64_t value = 0;
+            int shift = 0;
+            while (*data & 0x80) {
+                  value |= (uint64_t)(*data++ & 0x7F) << shift;
+                  shift += 7;
+            }
+            value |= (uint64_t)(*data++) << shift;
+            return value;
+      }
+
+      std::vector<Block> blocks;
+      std::mutex mutex;
+      bool compressed;
+      uint64_t tagCount;
+      size_t count;
+};
+
+#endif // PACKED_FRONTIER_H
@@ -13,7 +13,13 @@
  *   g++ -std=c++11 -O2 -fopenmp -o parallel_astar_h1_openmp.exe parallel_astar_h1_openmp.cpp
  * 
  * Usage:
- *   parallel_astar_h1_openmp.exe <puzzle> [num_threads]
+ *   parallel_astar_h1_openmp.exe <puzzle> [num_threads] [--tie POLICY] [--stats]
+ *   (an optional second input token is a custom goal: any board with the
+ *   same tiles, see goal_relabel.h)
+ *
+ *   --tie    any, high-g, lifo or fifo: order among states with equal f(n)
+ *            when the batch is taken from the open list (see tie_breaking.h)
+ *   --stats  Print the expanded-node count to stderr
  * 
  * Example:
  *   parallel_astar_h1_openmp.exe "EC#DBAJHIGFLMNKO" 4
@@ -30,13 +36,19 @@
 #include <chrono>
 #include <omp.h>
 #include <algorithm>
+#include <cstring>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "goal_relabel.h"
+#include "tie_breaking.h"
 
 using namespace std;
 using namespace chrono;
 
 const string TARGET = "ABCDEFGHIJKLMNO#";
-const int dRow[] = {-1, 1, 0, 0};
-const int dCol[] = {0, 0, -1, 1};
+string goalBoard = TARGET;  // TARGET or the custom goal of the input
+
+int lastNodesExpanded = 0; // Statistics of the last search
 
 // =============================================================================
 // STRUCTURES
@@ -47,9 +59,11 @@ struct State {
       int blankPos;
       int cost;      // g(n)
       int heuristic; // h(n)
+      int pruneState; // Move-pruning automaton state (see move_pruning_table.h)
+      long long order; // Generation sequence number, for tie-breaking (see tie_breaking.h)
       
-      State(string b, int pos, int c, int h) 
-            : board(b), blankPos(pos), cost(c), heuristic(h) {}
+      State(string b, int pos, int c, int h, int ps = MOVE_PRUNING_START, long long o = 0) 
+            : board(b), blankPos(pos), cost(c), heuristic(h), pruneState(ps), order(o) {}
       
       int f() const { return cost + heuristic; }
       
@@ -71,7 +85,7 @@ string swapTiles(const string& board, int pos1, int pos2) {
 int calculateH1(const string& board) {
       int misplaced = 0;
       for (int i = 0; i < 16; i++) {
-            if (board[i] != '#' && board[i] != TARGET[i]) {
+            if (board[i] != '#' && board[i] != goalBoard[i]) {
                   misplaced++;
             }
       }
@@ -82,7 +96,7 @@ int calculateH1(const string& board) {
 // PARALLEL A* ALGORITHM WITH H1
 // =============================================================================
 
-int parallelAStarH1(string start, int numThreads) {
+int parallelAStarH1(string start, int numThreads, TieBreakPolicy tiePolicy) {
       // Shared data structures
       vector<State> openList;
       unordered_set<string> closedSet;
@@ -96,12 +110,13 @@ int parallelAStarH1(string start, int numThreads) {
       bool solutionFound = false;
       int solution = -1;
       int nodesExpanded = 0;
+      long long generated = 1;
       
       omp_set_num_threads(numThreads);
       
       while (!openList.empty() && !solutionFound) {
             // Sort open list to get states with best f(n) values
-            sort(openList.begin(), openList.end(), greater<State>());
+            sort(openList.begin(), openList.end(), TieBreakCompare<State>(tiePolicy));
             
             // Determine batch size for parallel processing
             int batchSize = min((int)openList.size(), numThreads * 4);
@@ -136,7 +151,7 @@ int parallelAStarH1(string start, int numThreads) {
                         nodesExpanded++;
                         
                         // Check if goal is reached
-                        if (current.board == TARGET) {
+                        if (current.board == goalBoard) {
                               #pragma omp critical(solution_update)
                               {
                                     if (!solutionFound || current.cost < solution) {
@@ -148,32 +163,30 @@ int parallelAStarH1(string start, int numThreads) {
                         }
                         
                         // Expand neighbors
-                        int row = current.blankPos / 4;
-                        int col = current.blankPos % 4;
-                        
-                        for (int i = 0; i < 4; i++) {
-                              int newRow = row + dRow[i];
-                              int newCol = col + dCol[i];
+                        // Legal moves of the blank, precomputed per cell (successor_table.h)
+                        const SuccessorTable& moves = SuccessorTable::square(4);
+                        for (int k = 0; k < moves.count(current.blankPos); k++) {
+                              int i = moves.move(current.blankPos, k);
+                              // Inverse moves never reach the bestcost_update critical section
+                              int nextPruneState = MOVE_PRUNING_NEXT[current.pruneState][i];
+                              if (nextPruneState < 0) continue;
+                              int newPos = moves.neighbor(current.blankPos, k);
+                              string newBoard = swapTiles(current.board, current.blankPos, newPos);
+                              int newCost = current.cost + 1;
                               
-                              if (newRow >= 0 && newRow < 4 && newCol >= 0 && newCol < 4) {
-                                    int newPos = newRow * 4 + newCol;
-                                    string newBoard = swapTiles(current.board, current.blankPos, newPos);
-                                    int newCost = current.cost + 1;
-                                    
-                                    bool shouldAdd = false;
-                                    #pragma omp critical(bestcost_update)
-                                    {
-                                          if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
-                                                bestCost[newBoard] = newCost;
-                                                shouldAdd = true;
-                                          }
-                                    }
-                                    
-                                    if (shouldAdd) {
-                                          int h = calculateH1(newBoard);
-                                          localNewStates.push_back(State(newBoard, newPos, newCost, h));
+                              bool shouldAdd = false;
+                              #pragma omp critical(bestcost_update)
+                              {
+                                    if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
+                                          bestCost[newBoard] = newCost;
+                                          shouldAdd = true;
                                     }
                               }
+                              
+                              if (shouldAdd) {
+                                    int h = calculateH1(newBoard);
+                                    localNewStates.push_back(State(newBoard, newPos, newCost, h, nextPruneState));
+                              }
                         }
                   }
                   
@@ -184,11 +197,13 @@ int parallelAStarH1(string start, int numThreads) {
                   }
             }
             
-            // Add new states to open list
+            // Add new states to open list (numbered after the merge, so LIFO/FIFO
+            // order does not depend on which thread finished first)
+            for (size_t i = 0; i < newStates.size(); i++) newStates[i].order = generated++;
             openList.insert(openList.end(), newStates.begin(), newStates.end());
       }
       
-      //cout << "Nodes expanded: " << nodesExpanded << endl;
+      lastNodesExpanded = nodesExpanded;
       return solution;
 }
 
@@ -197,10 +212,37 @@ int parallelAStarH1(string start, int numThreads) {
 // =============================================================================
 
 int main(int argc, char* argv[]) {
-      string puzzle;
+      string puzzle, goal;
       cin >> puzzle;
       
-      int numThreads = (argc >= 2) ? atoi(argv[1]) : omp_get_max_threads();
+      // Optional custom goal: searched for directly, the blank may be anywhere
+      if (cin >> goal) {
+            if (!sameTiles(puzzle, goal, TARGET)) {
+                  cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                  return 1;
+            }
+            if (!goalReachable(puzzle, goal, 4)) {
+                  cout << -1 << endl;
+                  return 0;
+            }
+            goalBoard = goal;
+      }
+      
+      int numThreads = omp_get_max_threads();
+      TieBreakPolicy tiePolicy = TIE_ANY;
+      bool printStats = false;
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--tie") == 0 && i + 1 < argc) {
+                  if (!parseTieBreakPolicy(argv[++i], tiePolicy)) {
+                        cerr << "Error: unknown tie-breaking policy " << argv[i] << endl;
+                        return 1;
+                  }
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            } else {
+                  numThreads = atoi(argv[i]);
+            }
+      }
       
       //cout << "========================================" << endl;
       //cout << "Parallel A* with h1 (OpenMP)" << endl;
@@ -211,7 +253,7 @@ int main(int argc, char* argv[]) {
       //cout << "----------------------------------------" << endl;
       
       auto startTime = high_resolution_clock::now();
-      int solution = parallelAStarH1(puzzle, numThreads);
+      int solution = parallelAStarH1(puzzle, numThreads, tiePolicy);
       auto endTime = high_resolution_clock::now();
       
       double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
@@ -221,5 +263,10 @@ int main(int argc, char* argv[]) {
       //cout << "Time: " << timeMs << " ms" << endl;
       //cout << "========================================" << endl;
       
+      if (printStats) {
+            cerr << "Tie-breaking: " << tieBreakName(tiePolicy) << endl;
+            cerr << "Nodes expanded: " << lastNodesExpanded << endl;
+      }
+      
       return 0;
 }
@@ -7,12 +7,46 @@
  * 
  * Manhattan distance is more informed than h1, typically resulting in fewer
  * nodes expanded and faster convergence to the solution.
+ *
+ * States hold packed 64-bit boards (packed_board.h). Each thread gathers the
+ * states of the batch it takes from the closed-set check and expands them
+ * together with the struct-of-arrays kernel of batch_expand.h, which also
+ * updates h incrementally.
+ * 
+ * With --epea the search is Enhanced Partial Expansion A*: a node stored
+ * with value F = f(n) + surplus generates only the children whose f equals
+ * F and goes back to the open list with the next larger child f (at most
+ * once for Manhattan, whose children have f(n) or f(n) + 2). Children with
+ * larger f are never stored, so the open list and the best-cost table stay
+ * smaller: on depth-40 boards the open-list peak drops by 25-30% (110797 ->
+ * 77463 on HGJBIMAD#CELNKFO with one thread), while the re-queued nodes add
+ * about 20% more expansions. The selection uses the per-(blank cell, move,
+ * tile) h tables of the kernel (BatchExpander::expandPartial).
  * 
  * Compilation:
  *   g++ -std=c++11 -O2 -fopenmp -o parallel_astar_h2_openmp.exe parallel_astar_h2_openmp.cpp
  * 
  * Usage:
- *   parallel_astar_h2_openmp.exe <puzzle> [num_threads]
+ *   parallel_astar_h2_openmp.exe <puzzle> [num_threads] [--perf] [--tie POLICY] [--epea] [--stats]
+ *                                [--checkpoint FILE] [--checkpoint-every S]
+ *   (an optional second input token is a custom goal: any board with the
+ *   same tiles; the kernel's Manhattan tables follow it, see goal_relabel.h)
+ *
+ *   --tie    any, high-g, lifo or fifo: order among states with equal f(n)
+ *            when the batch is taken from the open list (see tie_breaking.h)
+ *   --epea   Enhanced Partial Expansion A* (see above)
+ *   --stats  Print the expanded-node count, open-list pushes and peak to stderr
+ *   --perf   Print per-phase, per-thread counters (cycles, instructions,
+ *            cache/TLB/branch misses per expanded node, see perf_counters.h)
+ *   --checkpoint FILE  Save the open list, the generated boards (best cost and
+ *            closed flag of each) and the counters to FILE whenever the
+ *            smallest f in the open list grows (written by a background
+ *            thread, see search_checkpoint.h). If FILE already holds a
+ *            snapshot of the same puzzle, the search resumes from it
+ *   --checkpoint-every S  Minimum seconds between snapshots (default 60)
+ *
+ *   Build with -DPUZZLE_TRACE to record a per-thread timeline (sort, batch
+ *   expansion, critical-section wait/hold) as Chrome trace JSON (trace_events.h).
  * 
  * Example:
  *   parallel_astar_h2_openmp.exe "EABCM#GDKFILNOJH" 4
@@ -30,28 +64,45 @@
 #include <omp.h>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include "move_pruning_table.h"
+#include "packed_board.h"
+#include "batch_expand.h"
+#include "goal_relabel.h"
+#include "tie_breaking.h"
+#include "perf_counters.h"
+#include "trace_events.h"
+#include "search_checkpoint.h"
 
 using namespace std;
 using namespace chrono;
 
 const string TARGET = "ABCDEFGHIJKLMNO#";
-const int dRow[] = {-1, 1, 0, 0};
-const int dCol[] = {0, 0, -1, 1};
+string goalBoard = TARGET;  // TARGET or the custom goal of the input
+
+// Statistics of the last search
+int lastNodesExpanded = 0;
+long long lastReexpansions = 0;  // EPEA*: partial expansions after the first
+long long lastPushes = 0;        // Open-list insertions
+size_t lastPeakOpen = 0;
 
 // =============================================================================
 // STRUCTURES
 // =============================================================================
 
 struct State {
-      string board;
+      PackedBoard board;
       int blankPos;
       int cost;      // g(n)
       int heuristic; // h(n)
+      int pruneState; // Move-pruning automaton state (see move_pruning_table.h)
+      long long order; // Generation sequence number, for tie-breaking (see tie_breaking.h)
+      int surplus;     // EPEA*: stored value F(n) - f(n), 0 until the first expansion
       
-      State(string b, int pos, int c, int h) 
-            : board(b), blankPos(pos), cost(c), heuristic(h) {}
+      State(PackedBoard b, int pos, int c, int h, int ps = MOVE_PRUNING_START, long long o = 0, int s = 0) 
+            : board(b), blankPos(pos), cost(c), heuristic(h), pruneState(ps), order(o), surplus(s) {}
       
-      int f() const { return cost + heuristic; }
+      int f() const { return cost + heuristic + surplus; }
       
       bool operator>(const State& other) const {
             return f() > other.f();
@@ -62,12 +113,6 @@ struct State {
 // HELPER FUNCTIONS
 // =============================================================================
 
-string swapTiles(const string& board, int pos1, int pos2) {
-      string newBoard = board;
-      swap(newBoard[pos1], newBoard[pos2]);
-      return newBoard;
-}
-
 /**
  * @brief Calculates h2 heuristic: sum of Manhattan distances
  * 
@@ -80,7 +125,7 @@ int calculateH2(const string& board) {
       for (int i = 0; i < 16; i++) {
             if (board[i] != '#') {
                   // Find goal position of this tile
-                  int goalPos = TARGET.find(board[i]);
+                  int goalPos = goalBoard.find(board[i]);
                   
                   // Convert positions to 2D coordinates
                   int currentRow = i / 4;
@@ -96,65 +141,242 @@ int calculateH2(const string& board) {
       return totalDistance;
 }
 
+// =============================================================================
+// CHECKPOINTS
+// =============================================================================
+
+// Snapshot counters: nodes expanded, states generated, f of the layer,
+// EPEA* re-expansions, open-list peak
+enum { ASTAR_NODES, ASTAR_GENERATED, ASTAR_F, ASTAR_REEXPANSIONS, ASTAR_PEAK, ASTAR_COUNTERS };
+
+/**
+ * @brief Search identity stored in snapshots: the start, and the goal when it is not TARGET
+ */
+string searchId(const string& start) {
+      return goalBoard == TARGET ? start : start + " " + goalBoard;
+}
+
+void snapshotAStar(CheckpointWriter& checkpoint, const string& start, bool epea, int nodesExpanded,
+                   long long generated, int f, long long reexpansions, size_t peakOpen, const vector<State>& openList,
+                   const unordered_set<PackedBoard>& closedSet, const unordered_map<PackedBoard, int>& bestCost) {
+      auto copyStarted = steady_clock::now();
+      SearchSnapshot snapshot;
+      snapshot.engine = epea ? "epea-h2" : "astar-h2";
+      snapshot.start = searchId(start);
+      snapshot.counters.resize(ASTAR_COUNTERS);
+      snapshot.counters[ASTAR_NODES] = nodesExpanded;
+      snapshot.counters[ASTAR_GENERATED] = generated;
+      snapshot.counters[ASTAR_F] = f;
+      snapshot.counters[ASTAR_REEXPANSIONS] = reexpansions;
+      snapshot.counters[ASTAR_PEAK] = peakOpen;
+      
+      // Blank and h are recomputed from the board on resume
+      vector<PackedBoard> boards;
+      vector<uint8_t> costs, pruneStates, surpluses;
+      vector<long long> orders;
+      for (size_t i = 0; i < openList.size(); i++) {
+            boards.push_back(openList[i].board);
+            costs.push_back(openList[i].cost);
+            pruneStates.push_back(openList[i].pruneState);
+            orders.push_back(openList[i].order);
+            surpluses.push_back(openList[i].surplus);
+      }
+      snapshot.put("open-board", boards);
+      snapshot.put("open-g", costs);
+      snapshot.put("open-prune", pruneStates);
+      snapshot.put("open-order", orders);
+      snapshot.put("open-surplus", surpluses);
+      
+      // Every closed board also has a best cost, so each board is stored once
+      vector<uint8_t> closed;
+      boards.clear();
+      costs.clear();
+      boards.reserve(bestCost.size());
+      costs.reserve(bestCost.size());
+      closed.reserve(bestCost.size());
+      for (auto it = bestCost.begin(); it != bestCost.end(); ++it) {
+            boards.push_back(it->first);
+            costs.push_back(it->second);
+            closed.push_back(closedSet.count(it->first));
+      }
+      snapshot.put("seen-board", boards);
+      snapshot.put("seen-g", costs);
+      snapshot.put("seen-closed", closed);
+      checkpoint.submit(snapshot, copyStarted);
+}
+
+bool restoreAStar(SearchSnapshot& snapshot, const BatchExpander& expander, int& nodesExpanded, long long& generated, int& f,
+                  long long& reexpansions, size_t& peakOpen, vector<State>& openList, unordered_set<PackedBoard>& closedSet,
+                  unordered_map<PackedBoard, int>& bestCost) {
+      vector<PackedBoard> boards;
+      vector<uint8_t> costs, pruneStates, surpluses;
+      vector<long long> orders;
+      if (snapshot.counters.size() != ASTAR_COUNTERS || !snapshot.get("open-board", boards) ||
+          !snapshot.get("open-g", costs) || !snapshot.get("open-prune", pruneStates) ||
+          !snapshot.get("open-order", orders) || !snapshot.get("open-surplus", surpluses) ||
+          costs.size() != boards.size() || pruneStates.size() != boards.size() ||
+          orders.size() != boards.size() || surpluses.size() != boards.size()) {
+            return false;
+      }
+      openList.clear();
+      for (size_t i = 0; i < boards.size(); i++) {
+            openList.push_back(State(boards[i], blockBlankPos(boards[i]), costs[i], expander.manhattan(boards[i]),
+                                     pruneStates[i], orders[i], surpluses[i]));
+      }
+      
+      vector<uint8_t> closed;
+      if (!snapshot.get("seen-board", boards) || !snapshot.get("seen-g", costs) ||
+          !snapshot.get("seen-closed", closed) || costs.size() != boards.size() || closed.size() != boards.size()) {
+            return false;
+      }
+      bestCost.clear();
+      bestCost.reserve(boards.size());
+      closedSet.clear();
+      for (size_t i = 0; i < boards.size(); i++) {
+            bestCost[boards[i]] = costs[i];
+            if (closed[i]) closedSet.insert(boards[i]);
+      }
+      
+      nodesExpanded = snapshot.counters[ASTAR_NODES];
+      generated = snapshot.counters[ASTAR_GENERATED];
+      f = snapshot.counters[ASTAR_F];
+      reexpansions = snapshot.counters[ASTAR_REEXPANSIONS];
+      peakOpen = snapshot.counters[ASTAR_PEAK];
+      snapshot.sections.clear();  // The copies are no longer needed
+      return true;
+}
+
 // =============================================================================
 // PARALLEL A* ALGORITHM WITH H2
 // =============================================================================
 
-int parallelAStarH2(string start, int numThreads) {
+/**
+ * @param epea Enhanced Partial Expansion: generate only the children with f = F(n)
+ * @param checkpoint Takes a snapshot when the smallest open f grows and one is due
+ * @param resume Snapshot to continue from, or null to start at the root
+ */
+int parallelAStarH2(string start, int numThreads, TieBreakPolicy tiePolicy, bool epea, PerfProfile& profile,
+                    CheckpointWriter& checkpoint, SearchSnapshot* resume) {
       // Shared data structures
       vector<State> openList;
-      unordered_set<string> closedSet;
-      unordered_map<string, int> bestCost;
+      unordered_set<PackedBoard> closedSet;
+      unordered_map<PackedBoard, int> bestCost;
+      PackedBoard goal = packBoard(goalBoard);
+      const BatchExpander expander(goal);
       
+      PackedBoard startBoard = packBoard(start);
       int blankPos = start.find('#');
       int h = calculateH2(start);
-      openList.push_back(State(start, blankPos, 0, h));
-      bestCost[start] = 0;
+      openList.push_back(State(startBoard, blankPos, 0, h));
+      bestCost[startBoard] = 0;
       
       bool solutionFound = false;
       int solution = -1;
       int nodesExpanded = 0;
+      long long generated = 1;
+      long long reexpansions = 0;
+      size_t peakOpen = 1;
+      int layerF = -1;  // Smallest f of the open list at the last batch
+      
+      if (resume && !restoreAStar(*resume, expander, nodesExpanded, generated, layerF, reexpansions, peakOpen, openList,
+                                  closedSet, bestCost)) {
+            cerr << "Error: checkpoint " << checkpoint.path() << " is not an A* snapshot" << endl;
+            return -1;
+      }
       
       omp_set_num_threads(numThreads);
       
+      int sortPhase = profile.addPhase("sort");
+      int expandPhase = profile.addPhase("expand");
+      int mergePhase = profile.addPhase("merge");
+      
       while (!openList.empty() && !solutionFound) {
-            // Sort open list to get states with best f(n) values
-            sort(openList.begin(), openList.end(), greater<State>());
+            TRACE_INSTANT("batch boundary");
+            int nodesBefore = nodesExpanded;
+            vector<State> currentBatch;
             
-            // Determine batch size for parallel processing
-            int batchSize = min((int)openList.size(), numThreads * 4);
-            vector<State> currentBatch(openList.end() - batchSize, openList.end());
-            openList.erase(openList.end() - batchSize, openList.end());
+            // f-layer boundary: saved before the sort, so that a resumed run
+            // sorts exactly the same list and takes the same batches
+            if (checkpoint.enabled()) {
+                  int minF = min_element(openList.begin(), openList.end(),
+                                         [](const State& a, const State& b) { return a.f() < b.f(); })->f();
+                  if (minF > layerF) {
+                        layerF = minF;
+                        if (checkpoint.due()) {
+                              snapshotAStar(checkpoint, start, epea, nodesExpanded, generated, layerF, reexpansions,
+                                            peakOpen, openList, closedSet, bestCost);
+                        }
+                  }
+            }
+            
+            {
+                  PerfProfile::Scope scope(profile, sortPhase, 0);
+                  TRACE_SCOPE("sort");
+                  
+                  // Sort open list to get states with best f(n) values
+                  sort(openList.begin(), openList.end(), TieBreakCompare<State>(tiePolicy));
+                  
+                  // Determine batch size for parallel processing
+                  int batchSize = min((int)openList.size(), numThreads * 4);
+                  currentBatch.assign(openList.end() - batchSize, openList.end());
+                  openList.erase(openList.end() - batchSize, openList.end());
+            }
             
             vector<State> newStates;
             
             #pragma omp parallel num_threads(numThreads)
             {
+                  TRACE_BEGIN("parallel region");
                   vector<State> localNewStates;
+                  NodeBlock parents, children;
+                  vector<uint8_t> nextSurplus;
+                  bool expanded = false;
+                  PerfProfile::Scope scope(profile, expandPhase, omp_get_thread_num());
                   
+                  TRACE_BEGIN("expand batch");
                   #pragma omp for schedule(dynamic) nowait
                   for (int idx = 0; idx < currentBatch.size(); idx++) {
                         if (solutionFound) continue;
                         
                         State current = currentBatch[idx];
                         
+                        // EPEA*: a re-queued node was closed at its first expansion;
+                        // it is dropped only if a shorter path reached the board since
+                        if (current.surplus > 0) {
+                              bool stale;
+                              #pragma omp critical(bestcost_update)
+                              stale = bestCost[current.board] < current.cost;
+                              if (stale) continue;
+                              
+                              #pragma omp atomic
+                              reexpansions++;
+                              parents.push(current.board, current.blankPos, current.cost, current.heuristic,
+                                           current.pruneState, current.surplus);
+                              continue;
+                        }
+                        
                         // Skip if already in closed set
                         bool inClosed = false;
+                        TRACE_BEGIN("wait closed_check");
                         #pragma omp critical(closed_check)
                         {
+                              TRACE_END("wait closed_check");
+                              TRACE_BEGIN("hold closed_check");
                               inClosed = closedSet.count(current.board);
                               if (!inClosed) {
                                     closedSet.insert(current.board);
                               }
+                              TRACE_END("hold closed_check");
                         }
                         
                         if (inClosed) continue;
                         
                         #pragma omp atomic
                         nodesExpanded++;
+                        scope.addNodes(1);
                         
                         // Check if goal is reached
-                        if (current.board == TARGET) {
+                        if (current.board == goal) {
                               #pragma omp critical(solution_update)
                               {
                                     if (!solutionFound || current.cost < solution) {
@@ -165,48 +387,84 @@ int parallelAStarH2(string start, int numThreads) {
                               continue;
                         }
                         
-                        // Expand neighbors
-                        int row = current.blankPos / 4;
-                        int col = current.blankPos % 4;
+                        parents.push(current.board, current.blankPos, current.cost, current.heuristic,
+                                     current.pruneState);
+                  }
+                  
+                  // Expand this thread's share of the batch in one kernel call
+                  // (moves completing a redundant sequence are already pruned;
+                  // EPEA* keeps only the children with f = F(n))
+                  if (!solutionFound) {
+                        if (epea) expander.expandPartial(parents, children, nextSurplus);
+                        else expander.expand(parents, children);
+                        expanded = true;
+                  }
+                  
+                  for (size_t c = 0; c < children.size(); c++) {
+                        PackedBoard newBoard = children.board[c];
+                        int newCost = children.g[c];
                         
-                        for (int i = 0; i < 4; i++) {
-                              int newRow = row + dRow[i];
-                              int newCol = col + dCol[i];
-                              
-                              if (newRow >= 0 && newRow < 4 && newCol >= 0 && newCol < 4) {
-                                    int newPos = newRow * 4 + newCol;
-                                    string newBoard = swapTiles(current.board, current.blankPos, newPos);
-                                    int newCost = current.cost + 1;
-                                    
-                                    bool shouldAdd = false;
-                                    #pragma omp critical(bestcost_update)
-                                    {
-                                          if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
-                                                bestCost[newBoard] = newCost;
-                                                shouldAdd = true;
-                                          }
-                                    }
-                                    
-                                    if (shouldAdd) {
-                                          int h = calculateH2(newBoard);
-                                          localNewStates.push_back(State(newBoard, newPos, newCost, h));
-                                    }
+                        bool shouldAdd = false;
+                        TRACE_BEGIN("wait bestcost_update");
+                        #pragma omp critical(bestcost_update)
+                        {
+                              TRACE_END("wait bestcost_update");
+                              TRACE_BEGIN("hold bestcost_update");
+                              if (!bestCost.count(newBoard) || newCost < bestCost[newBoard]) {
+                                    bestCost[newBoard] = newCost;
+                                    shouldAdd = true;
                               }
+                              TRACE_END("hold bestcost_update");
+                        }
+                        
+                        if (shouldAdd) {
+                              localNewStates.push_back(State(newBoard, children.blankPos[c], newCost, children.h[c],
+                                                             children.pruneState[c]));
                         }
                   }
                   
+                  
+                  // EPEA*: parents with children left go back with the next F
+                  for (size_t p = 0; epea && expanded && p < parents.size(); p++) {
+                        if (nextSurplus[p] == BatchExpander::NO_SURPLUS) continue;
+                        localNewStates.push_back(State(parents.board[p], parents.blankPos[p], parents.g[p],
+                                                       parents.h[p], parents.pruneState[p], 0, nextSurplus[p]));
+                  }
+                  
+                  TRACE_END("expand batch");
+                  
                   // Merge local new states into global list
+                  TRACE_BEGIN("wait openlist_update");
                   #pragma omp critical(openlist_update)
                   {
+                        TRACE_END("wait openlist_update");
+                        TRACE_BEGIN("hold openlist_update");
                         newStates.insert(newStates.end(), localNewStates.begin(), localNewStates.end());
+                        TRACE_END("hold openlist_update");
                   }
+                  TRACE_END("parallel region");
             }
             
             // Add new states to open list
-            openList.insert(openList.end(), newStates.begin(), newStates.end());
+            {
+                  PerfProfile::Scope scope(profile, mergePhase, 0);
+                  TRACE_SCOPE("merge");
+                  // Numbered after the merge, so LIFO/FIFO order does not
+                  // depend on which thread finished first
+                  for (size_t i = 0; i < newStates.size(); i++) newStates[i].order = generated++;
+                  openList.insert(openList.end(), newStates.begin(), newStates.end());
+                  peakOpen = max(peakOpen, openList.size());
+            }
+            
+            // Sorting and merging are charged to the nodes of this batch
+            profile.addNodes(sortPhase, 0, nodesExpanded - nodesBefore);
+            profile.addNodes(mergePhase, 0, nodesExpanded - nodesBefore);
       }
       
-      //cout << "Nodes expanded: " << nodesExpanded << endl;
+      lastNodesExpanded = nodesExpanded;
+      lastReexpansions = reexpansions;
+      lastPushes = generated;
+      lastPeakOpen = peakOpen;
       return solution;
 }
 
@@ -215,10 +473,59 @@ int parallelAStarH2(string start, int numThreads) {
 // =============================================================================
 
 int main(int argc, char* argv[]) {
-      string puzzle;
+      string puzzle, goal;
       cin >> puzzle;
       
-      int numThreads = (argc >= 2) ? atoi(argv[1]) : omp_get_max_threads();
+      // Optional custom goal: searched for directly, the blank may be anywhere
+      if (cin >> goal) {
+            if (!sameTiles(puzzle, goal, TARGET)) {
+                  cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                  return 1;
+            }
+            if (!goalReachable(puzzle, goal, 4)) {
+                  cout << -1 << endl;
+                  return 0;
+            }
+            goalBoard = goal;
+      }
+      
+      int numThreads = omp_get_max_threads();
+      bool perf = false;
+      TieBreakPolicy tiePolicy = TIE_ANY;
+      bool printStats = false;
+      bool epea = false;
+      string checkpointFile;
+      double checkpointEvery = 60;
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--perf") == 0) {
+                  perf = true;
+            } else if (strcmp(argv[i], "--tie") == 0 && i + 1 < argc) {
+                  if (!parseTieBreakPolicy(argv[++i], tiePolicy)) {
+                        cerr << "Error: unknown tie-breaking policy " << argv[i] << endl;
+                        return 1;
+                  }
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            } else if (strcmp(argv[i], "--epea") == 0) {
+                  epea = true;
+            } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+                  checkpointFile = argv[++i];
+            } else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+                  checkpointEvery = atof(argv[++i]);
+            } else {
+                  numThreads = atoi(argv[i]);
+            }
+      }
+      PerfProfile profile(perf, numThreads);
+      
+      SearchSnapshot snapshot;
+      bool resuming = !checkpointFile.empty() && loadSnapshot(checkpointFile, snapshot);
+      if (resuming && (snapshot.engine != (epea ? "epea-h2" : "astar-h2") || snapshot.start != searchId(puzzle))) {
+            cerr << "Error: checkpoint " << checkpointFile << " belongs to another search ("
+                 << snapshot.engine << " " << snapshot.start << ")" << endl;
+            return 1;
+      }
+      CheckpointWriter checkpoint(checkpointFile, checkpointEvery);
       
       //cout << "========================================" << endl;
       //cout << "Parallel A* with h2 (OpenMP)" << endl;
@@ -230,7 +537,8 @@ int main(int argc, char* argv[]) {
       //cout << "----------------------------------------" << endl;
       
       auto startTime = high_resolution_clock::now();
-      int solution = parallelAStarH2(puzzle, numThreads);
+      int solution = parallelAStarH2(puzzle, numThreads, tiePolicy, epea, profile, checkpoint,
+                                     resuming ? &snapshot : nullptr);
       auto endTime = high_resolution_clock::now();
       
       double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
@@ -240,5 +548,18 @@ int main(int argc, char* argv[]) {
       //cout << "Time: " << timeMs << " ms" << endl;
       //cout << "========================================" << endl;
       
+      if (perf) {
+            cerr << "Time: " << timeMs << " ms" << endl;
+            profile.print(cerr);
+      }
+      if (printStats) {
+            cerr << "Tie-breaking: " << tieBreakName(tiePolicy) << endl;
+            cerr << "Nodes expanded: " << lastNodesExpanded << endl;
+            if (epea) cerr << "Partial re-expansions: " << lastReexpansions << endl;
+            cerr << "Open-list pushes: " << lastPushes << ", peak: " << lastPeakOpen << endl;
+            if (resuming) cerr << "Resumed at f = " << snapshot.counters[ASTAR_F] << endl;
+            if (checkpoint.enabled()) checkpoint.printStats(cerr);
+      }
+      
       return 0;
 }
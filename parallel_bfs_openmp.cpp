@@ -10,135 +10,447 @@
  *   g++ -std=c++11 -O2 -fopenmp -o parallel_bfs_openmp.exe parallel_bfs_openmp.cpp
  * 
  * Usage:
- *   parallel_bfs_openmp.exe <puzzle> [num_threads]
+ *   parallel_bfs_openmp.exe <puzzle> [num_threads] [--bloom-mb MB] [--verify]
+ *                          [--compress-frontier] [--stats] [--perf]
+ *   (an optional second input token is a custom goal: any board with the
+ *   same tiles, compared directly, see goal_relabel.h)
+ *
+ *   --bloom-mb MB  Bounded-memory mode: older layers are kept in a Bloom filter
+ *                  of MB megabytes and only the layer being built is stored
+ *                  exactly. States the filter wrongly reports as seen are lost,
+ *                  so the result may be longer than optimal (or -1).
+ *   --verify       Also keep the exact visited set and count the filter's
+ *                  false positives (the result is then exact)
+ *   --compress-frontier  Store every frontier block as sorted, delta-encoded
+ *                  permutation ranks (about half the memory of raw boards)
+ *   --stats        Print the size of every layer to stderr
+ *   --perf         Print per-phase, per-thread counters (cycles, instructions,
+ *                  cache/TLB/branch misses per expanded node, see perf_counters.h)
+ *   --checkpoint FILE  Save the visited set, the frontier and the counters to
+ *                  FILE at level boundaries (written by a background thread,
+ *                  see search_checkpoint.h). If FILE already holds a snapshot
+ *                  of the same puzzle, the search resumes from it
+ *   --checkpoint-every S  Minimum seconds between snapshots (default 60)
+ *   --frontier     Frontier search (frontier_search.h): keep only the open
+ *                  layers, with used-operator bits instead of the visited set,
+ *                  and rebuild the path by divide and conquer. Prints the
+ *                  blank moves ("UDLR" letters, "-" if none) before the length
+ *
+ *   Build with -DPUZZLE_TRACE to record a per-thread timeline (layers and block
+ *   expansion) as Chrome trace JSON (trace_events.h).
  * 
  * @author JAPeTo
  * @version 2.0
  */
 
 #include <iostream>
-#include <queue>
 #include <unordered_set>
 #include <vector>
 #include <chrono>
+#include <cstring>
 #include <omp.h>
+#include "goal_relabel.h"
+#include "packed_board.h"
+#include "bloom_filter.h"
+#include "packed_frontier.h"
+#include "batch_expand.h"
+#include "perf_counters.h"
+#include "trace_events.h"
+#include "search_checkpoint.h"
+#include "frontier_search.h"
 
 using namespace std;
 using namespace chrono;
 
 const string TARGET = "ABCDEFGHIJKLMNO#";
-const int dRow[] = {-1, 1, 0, 0};
-const int dCol[] = {0, 0, -1, 1};
 
-struct State {
-      string board;
-      int blankPos;
-      int cost;
+// =============================================================================
+// CHECKPOINTS
+// =============================================================================
+
+// Snapshot counters: level of the frontier, nodes expanded, states generated
+enum { BFS_DEPTH, BFS_NODES, BFS_STATES, BFS_COUNTERS };
+
+/**
+ * @brief Search identity stored in snapshots: the start, and the goal when it is not TARGET
+ */
+string searchId(const string& start, const string& goal) {
+      return goal == TARGET ? start : start + " " + goal;
+}
+
+void snapshotBFS(CheckpointWriter& checkpoint, const string& id, int depth, int nodesExpanded,
+                 long long totalStates, const unordered_set<PackedBoard>& visited,
+                 const PackedFrontier& frontier) {
+      auto copyStarted = steady_clock::now();
+      SearchSnapshot snapshot;
+      snapshot.engine = "bfs";
+      snapshot.start = id;
+      snapshot.counters.resize(BFS_COUNTERS);
+      snapshot.counters[BFS_DEPTH] = depth;
+      snapshot.counters[BFS_NODES] = nodesExpanded;
+      snapshot.counters[BFS_STATES] = totalStates;
       
-      State(string b, int pos, int c) : board(b), blankPos(pos), cost(c) {}
-};
+      vector<PackedBoard> boards;
+      boards.reserve(visited.size());
+      for (auto it = visited.begin(); it != visited.end(); ++it) boards.push_back(*it);
+      snapshot.put("visited", boards);
+      boards.clear();
+      vector<PackedBoard> block;
+      vector<uint8_t> prune, blockPrune;
+      for (size_t b = 0; b < frontier.blockCount(); b++) {
+            frontier.readBlock(b, block, blockPrune);
+            boards.insert(boards.end(), block.begin(), block.end());
+            prune.insert(prune.end(), blockPrune.begin(), blockPrune.end());
+      }
+      snapshot.put("frontier", boards);
+      snapshot.put("frontier-prune", prune);
+      checkpoint.submit(snapshot, copyStarted);
+}
 
-string swapTiles(const string& board, int pos1, int pos2) {
-      string newBoard = board;
-      swap(newBoard[pos1], newBoard[pos2]);
-      return newBoard;
+bool restoreBFS(SearchSnapshot& snapshot, int& depth, int& nodesExpanded, long long& totalStates,
+                unordered_set<PackedBoard>& visited, PackedFrontier& frontier) {
+      vector<PackedBoard> boards;
+      if (snapshot.counters.size() != BFS_COUNTERS || !snapshot.get("visited", boards)) return false;
+      visited.clear();
+      visited.reserve(boards.size());
+      visited.insert(boards.begin(), boards.end());
+      vector<uint8_t> prune;
+      if (!snapshot.get("frontier", boards) || !snapshot.get("frontier-prune", prune)) return false;
+      if (prune.size() != boards.size()) return false;
+      frontier.clear();
+      frontier.append(boards, prune);
+      depth = snapshot.counters[BFS_DEPTH];
+      nodesExpanded = snapshot.counters[BFS_NODES];
+      totalStates = snapshot.counters[BFS_STATES];
+      snapshot.sections.clear();  // The copies are no longer needed
+      return true;
 }
 
-int parallelBFS(string start, int numThreads) {
-      vector<State> currentLevel;
-      vector<State> nextLevel;
-      unordered_set<string> visited;
+// =============================================================================
+// PARALLEL BFS
+// =============================================================================
+
+/**
+ * @brief Level-synchronous parallel BFS over packed boards
+ *
+ * Layers are PackedFrontier objects: one 64-bit board per entry, tagged with
+ * the move-pruning state of the path that reached it; the level is the loop
+ * counter and the blank position is read back from the board. With the tag
+ * the kernel never generates the inverse of the last move, so the parent is
+ * not probed in the visited set (or the Bloom filter) again. Every frontier
+ * block is expanded at once by the struct-of-arrays kernel of batch_expand.h;
+ * only the visited-set updates remain per child.
+ *
+ * @param bloom Bounded-memory mode when not null: older layers are answered by
+ *              the filter and only the layer being built is stored exactly
+ * @param verify With bloom, also keep every layer exactly to detect false positives
+ * @param compressFrontier Sort and delta-encode every frontier block
+ * @param checkpoint Takes a snapshot at level boundaries when one is due (exact mode)
+ * @param resume Snapshot to continue from, or null to start at the root
+ */
+int parallelBFS(string start, const string& goalBoard, int numThreads, BlockedBloomFilter* bloom, bool verify,
+                bool compressFrontier, bool printStats, PerfProfile& profile,
+                CheckpointWriter& checkpoint, SearchSnapshot* resume) {
+      PackedFrontier currentLevel(compressFrontier, MOVE_PRUNING_STATES);
+      PackedFrontier nextLevel(compressFrontier, MOVE_PRUNING_STATES);
+      unordered_set<PackedBoard> visited;    // exact mode: every state seen
+      unordered_set<PackedBoard> levelSet;   // bloom mode: layer being built
+      unordered_set<PackedBoard> olderExact; // bloom + verify: every older layer
       
-      int blankPos = start.find('#');
-      currentLevel.push_back(State(start, blankPos, 0));
-      visited.insert(start);
+      PackedBoard startBoard = packBoard(start);
+      PackedBoard goal = packBoard(goalBoard);
+      vector<PackedBoard> firstLevel(1, startBoard);
+      currentLevel.append(firstLevel);
+      if (bloom) {
+            bloom->insert(startBoard);
+            if (verify) olderExact.insert(startBoard);
+      } else {
+            visited.insert(startBoard);
+      }
       
       int nodesExpanded = 0;
       bool foundSolution = false;
       int solution = -1;
+      long long rejected = 0;       // candidates the filter reported as already seen
+      long long falsePositives = 0; // of those, never actually seen (verify only)
+      long long totalStates = 1;
+      int depth = 0;
+      
+      if (resume && !restoreBFS(*resume, depth, nodesExpanded, totalStates, visited, currentLevel)) {
+            cerr << "Error: checkpoint " << checkpoint.path() << " is not a BFS snapshot" << endl;
+            return -1;
+      }
+      
+      int expandPhase = profile.addPhase("expand");
+      int layerPhase = profile.addPhase("layer");
+      const BatchExpander expander;
       
       while (!currentLevel.empty() && !foundSolution) {
+            TRACE_INSTANT("layer boundary");
+            if (checkpoint.due()) {
+                  snapshotBFS(checkpoint, searchId(start, goalBoard), depth, nodesExpanded, totalStates, visited, currentLevel);
+            }
             nextLevel.clear();
             
+            // Small layers use small blocks so that every thread gets work
+            size_t flushSize = currentLevel.size() * 2 / (numThreads * 4);
+            flushSize = max((size_t)64, min(PackedFrontier::BLOCK_KEYS, flushSize));
+            
             #pragma omp parallel num_threads(numThreads)
             {
-                  vector<State> localNextLevel;
+                  TRACE_BEGIN("parallel region");
+                  vector<PackedBoard> block;
+                  vector<uint8_t> blockPrune;
+                  vector<PackedBoard> localNextLevel;
+                  vector<uint8_t> localNextPrune;
+                  NodeBlock parents, children;
+                  PerfProfile::Scope scope(profile, expandPhase, omp_get_thread_num());
                   
                   #pragma omp for schedule(dynamic)
-                  for (int idx = 0; idx < currentLevel.size(); idx++) {
+                  for (int b = 0; b < (int)currentLevel.blockCount(); b++) {
                         if (foundSolution) continue;
+                        TRACE_SCOPE("expand block");
+                        currentLevel.readBlock(b, block, blockPrune);
                         
-                        State current = currentLevel[idx];
-                        
-                        #pragma omp atomic
-                        nodesExpanded++;
-                        
-                        // Check if goal is reached
-                        if (current.board == TARGET) {
-                              #pragma omp critical
-                              {
-                                    if (!foundSolution) {
-                                          foundSolution = true;
-                                          solution = current.cost;
+                        // Goal test, then the whole block goes through the kernel
+                        parents.clear();
+                        for (size_t idx = 0; idx < block.size(); idx++) {
+                              if (block[idx] == goal) {
+                                    #pragma omp critical
+                                    {
+                                          if (!foundSolution) {
+                                                foundSolution = true;
+                                                solution = depth;
+                                          }
                                     }
+                                    break;
                               }
-                              continue;
+                              parents.push(block[idx], blockBlankPos(block[idx]), depth, 0, blockPrune[idx]);
                         }
                         
-                        int row = current.blankPos / 4;
-                        int col = current.blankPos % 4;
+                        #pragma omp atomic
+                        nodesExpanded += (int)parents.size();
+                        scope.addNodes(parents.size());
+                        if (foundSolution) continue;
+                        
+                        expander.expand(parents, children);
                         
-                        // Explore neighbors
-                        for (int i = 0; i < 4; i++) {
-                              int newRow = row + dRow[i];
-                              int newCol = col + dCol[i];
+                        for (size_t c = 0; c < children.size(); c++) {
+                              PackedBoard newBoard = children.board[c];
                               
-                              if (newRow >= 0 && newRow < 4 && newCol >= 0 && newCol < 4) {
-                                    int newPos = newRow * 4 + newCol;
-                                    string newBoard = swapTiles(current.board, current.blankPos, newPos);
-                                    
-                                    bool shouldAdd = false;
+                              bool shouldAdd = false;
+                              if (!bloom) {
                                     #pragma omp critical(visited_update)
                                     {
-                                          if (visited.find(newBoard) == visited.end()) {
-                                                visited.insert(newBoard);
-                                                shouldAdd = true;
-                                          }
+                                          shouldAdd = visited.insert(newBoard).second;
+                                    }
+                              } else {
+                                    // Exact check against this layer, approximate against older ones
+                                    #pragma omp critical(visited_update)
+                                    {
+                                          shouldAdd = levelSet.insert(newBoard).second;
                                     }
                                     
-                                    if (shouldAdd) {
-                                          localNextLevel.push_back(State(newBoard, newPos, current.cost + 1));
+                                    if (shouldAdd && bloom->mayContain(newBoard)) {
+                                          shouldAdd = false;
+                                          if (verify && olderExact.find(newBoard) == olderExact.end()) {
+                                                shouldAdd = true;
+                                                #pragma omp atomic
+                                                falsePositives++;
+                                          }
+                                          #pragma omp atomic
+                                          rejected++;
                                     }
                               }
+                              
+                              if (shouldAdd) {
+                                    localNextLevel.push_back(newBoard);
+                                    localNextPrune.push_back(children.pruneState[c]);
+                                    if (localNextLevel.size() >= flushSize) nextLevel.append(localNextLevel, localNextPrune);
+                              }
                         }
                   }
                   
-                  // Merge local results into global next level
-                  #pragma omp critical(nextlevel_update)
+                  // Hand the remaining local results to the next level
+                  nextLevel.append(localNextLevel, localNextPrune);
+                  TRACE_END("parallel region");
+            }
+            
+            if (foundSolution) break;
+            depth++;
+            totalStates += nextLevel.size();
+            
+            // Closing a layer is charged to the nodes it produced
+            PerfProfile::Scope layerScope(profile, layerPhase, 0);
+            layerScope.addNodes(nextLevel.size());
+            
+            // The finished layer becomes an older layer
+            if (bloom) {
+                  #pragma omp parallel num_threads(numThreads)
                   {
-                        nextLevel.insert(nextLevel.end(), localNextLevel.begin(), localNextLevel.end());
+                        vector<PackedBoard> block;
+                        #pragma omp for schedule(dynamic)
+                        for (int b = 0; b < (int)nextLevel.blockCount(); b++) {
+                              nextLevel.readBlock(b, block);
+                              for (size_t idx = 0; idx < block.size(); idx++) bloom->insert(block[idx]);
+                        }
                   }
+                  if (verify) {
+                        vector<PackedBoard> block;
+                        for (size_t b = 0; b < nextLevel.blockCount(); b++) {
+                              nextLevel.readBlock(b, block);
+                              olderExact.insert(block.begin(), block.end());
+                        }
+                  }
+                  levelSet.clear();
             }
             
-            if (foundSolution) break;
-            currentLevel = nextLevel;
+            if (printStats) {
+                  cerr << "Layer " << depth << ": " << nextLevel.size() << " states, frontier "
+                       << nextLevel.bytes() << " bytes" << endl;
+            }
+            currentLevel.swap(nextLevel);
+      }
+      
+      if (printStats) {
+            cerr << "States generated: " << totalStates << endl;
+            if (bloom) {
+                  cerr << "Bloom filter: " << bloom->bytes() / (1024 * 1024) << " MB, "
+                       << bloom->size() << " keys, estimated false-positive rate: "
+                       << bloom->estimatedFalsePositiveRate() << endl;
+                  cerr << "Rejected as seen: " << rejected;
+                  if (verify) cerr << ", false positives: " << falsePositives;
+                  cerr << endl;
+            }
       }
       
       //cout << "Nodes expanded: " << nodesExpanded << endl;
       return solution;
 }
 
+// =============================================================================
+// FRONTIER SEARCH
+// =============================================================================
+
+/**
+ * @brief Packed 4x4 boards for FrontierSearch
+ */
+struct PackedSpace {
+      typedef PackedBoard State;
+      
+      int side() const { return 4; }
+      int blank(PackedBoard board) const { return blockBlankPos(board); }
+      int tile(PackedBoard board, int cell) const { return packedTile(board, cell); }
+      PackedBoard slide(PackedBoard board, int blank, int target) const { return packedMove(board, blank, target); }
+};
+
+/**
+ * @brief Frontier search from start to goal
+ * @param path Output: the blank moves
+ */
+int frontierBFS(const string& start, const string& goal, int numThreads, bool printStats, string& path) {
+      PackedSpace space;
+      FrontierSearch<PackedSpace> search(space, numThreads);
+      if (printStats) {
+            search.setLayerCallback([](int depth, size_t states) {
+                  cerr << "Layer " << depth << ": " << states << " states" << endl;
+            });
+      }
+      int solution = search.solve(packBoard(start), packBoard(goal), path);
+      if (printStats) {
+            cerr << "Frontier search: " << search.searchNodes() << " nodes expanded, " << search.pathNodes()
+                 << " more in " << search.searches() - 1 << " searches to rebuild the path, peak "
+                 << search.peakStates() << " states stored" << endl;
+      }
+      return solution;
+}
+
 int main(int argc, char* argv[]) {
-      string puzzle;
+      string puzzle, goal;
       cin >> puzzle;
+      if (!(cin >> goal)) goal = TARGET;
+      
+      int numThreads = omp_get_max_threads();
+      size_t bloomMB = 0;
+      bool verify = false;
+      bool compressFrontier = false;
+      bool printStats = false;
+      bool perf = false;
+      string checkpointFile;
+      double checkpointEvery = 60;
+      bool frontier = false;
+      
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--bloom-mb") == 0 && i + 1 < argc) {
+                  bloomMB = atol(argv[++i]);
+            } else if (strcmp(argv[i], "--verify") == 0) {
+                  verify = true;
+            } else if (strcmp(argv[i], "--compress-frontier") == 0) {
+                  compressFrontier = true;
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            } else if (strcmp(argv[i], "--perf") == 0) {
+                  perf = true;
+            } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+                  checkpointFile = argv[++i];
+            } else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+                  checkpointEvery = atof(argv[++i]);
+            } else if (strcmp(argv[i], "--frontier") == 0) {
+                  frontier = true;
+            } else {
+                  numThreads = atoi(argv[i]);
+            }
+      }
+      
+      PerfProfile profile(perf, numThreads);
+      
+      // A custom goal is searched for directly: no tables, so the blank may be anywhere
+      if (goal != TARGET) {
+            if (!sameTiles(puzzle, goal, TARGET)) {
+                  cerr << "Error: puzzle and goal must both use the tiles of " << TARGET << endl;
+                  return 1;
+            }
+            if (!goalReachable(puzzle, goal, 4)) {
+                  cout << -1 << endl;
+                  return 0;
+            }
+      }
+      
+      if (frontier) {
+            if (bloomMB > 0 || compressFrontier || !checkpointFile.empty()) {
+                  cerr << "Error: --frontier keeps no visited set or frontier blocks"
+                       << " (no --bloom-mb, --compress-frontier or --checkpoint)" << endl;
+                  return 1;
+            }
+            string path;
+            int solution = frontierBFS(puzzle, goal, numThreads, printStats, path);
+            if (solution >= 0) cout << (path.empty() ? "-" : path) << endl;
+            cout << solution << endl;
+            return 0;
+      }
+      
+      if (!checkpointFile.empty() && bloomMB > 0) {
+            cerr << "Error: --checkpoint needs the exact visited set (no --bloom-mb)" << endl;
+            return 1;
+      }
+      SearchSnapshot snapshot;
+      bool resuming = !checkpointFile.empty() && loadSnapshot(checkpointFile, snapshot);
+      if (resuming && (snapshot.engine != "bfs" || snapshot.start != searchId(puzzle, goal))) {
+            cerr << "Error: checkpoint " << checkpointFile << " belongs to another search ("
+                 << snapshot.engine << " " << snapshot.start << ")" << endl;
+            return 1;
+      }
+      CheckpointWriter checkpoint(checkpointFile, checkpointEvery);
       
-      int numThreads = (argc >= 2) ? atoi(argv[1]) : omp_get_max_threads();
+      BlockedBloomFilter* bloom = nullptr;
+      if (bloomMB > 0) bloom = new BlockedBloomFilter(bloomMB * 1024 * 1024);
       
       //cout << "Solving puzzle: " << puzzle << endl;
       //cout << "Using " << numThreads << " threads" << endl;
       
       auto startTime = high_resolution_clock::now();
-      int solution = parallelBFS(puzzle, numThreads);
+      int solution = parallelBFS(puzzle, goal, numThreads, bloom, verify, compressFrontier, printStats, profile,
+                                 checkpoint, resuming ? &snapshot : nullptr);
       auto endTime = high_resolution_clock::now();
       
       double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
@@ -146,5 +458,15 @@ int main(int argc, char* argv[]) {
       cout << solution << endl;
       //cout << "Time: " << timeMs << " ms" << endl;
       
+      if (perf) {
+            cerr << "Time: " << timeMs << " ms" << endl;
+            profile.print(cerr);
+      }
+      if (printStats && checkpoint.enabled()) {
+            if (resuming) cerr << "Resumed from level " << snapshot.counters[BFS_DEPTH] << endl;
+            checkpoint.printStats(cerr);
+      }
+      
+      delete bloom;
       return 0;
 }
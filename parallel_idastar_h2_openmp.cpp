@@ -0,0 +1,415 @@
+/**
+ * @file parallel_idastar_h2_openmp.cpp
+ * @brief Parallel IDA* with h2 heuristic (Manhattan distance) using OpenMP
+ *
+ * Depth-first alternative to parallelAStarH2: memory stays proportional to the
+ * search depth instead of the number of generated states.
+ *
+ * Parallelization strategy:
+ *   1. The root is expanded breadth-first (tree search, with move pruning)
+ *      until there are enough subtrees for all threads.
+ *   2. Every IDA* iteration distributes the subtrees with schedule(dynamic).
+ *   3. All threads share one lock-free transposition table that stores the
+ *      best known lower bound of each visited state, so subtrees reached from
+ *      different roots are cut off as soon as their bound exceeds the threshold.
+ *   4. An optional persistent cache (solved_state_cache.h) holds exact
+ *      distances of every state on previously found optimal paths; it is
+ *      checked before the search and used as an exact h during the search.
+ *   5. An optional row pattern database with reflected and dual lookups
+ *      (symmetry_heuristic.h) raises h above Manhattan distance.
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -fopenmp -o parallel_idastar_h2_openmp.exe parallel_idastar_h2_openmp.cpp
+ *
+ * Usage:
+ *   parallel_idastar_h2_openmp.exe [num_threads] [--tt-mb MB] [--cache FILE]
+ *                                  [--heuristic manhattan|pdb] [--stats] < "puzzle [goal]"
+ *
+ *   --tt-mb MB   Transposition table memory budget (default 64, 0 disables it)
+ *   --cache FILE Persistent solved-state cache (created if missing)
+ *   --heuristic  manhattan (default) or pdb: max of the row pattern database
+ *                on the board, its diagonal reflection and its dual
+ *   --stats      Print nodes per iteration and table counters to stderr
+ *
+ *   A custom goal with the blank in a corner is relabelled onto TARGET, so
+ *   the cache and the pattern database still apply; any other goal is
+ *   searched with Manhattan distances to its own cells and without them.
+ *
+ * Example:
+ *   echo "EABCM#GDKFILNOJH" | parallel_idastar_h2_openmp.exe 4 --tt-mb 256 --stats
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <omp.h>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "packed_board.h"
+#include "transposition_table.h"
+#include "solved_state_cache.h"
+#include "goal_relabel.h"
+#include "symmetry_heuristic.h"
+
+using namespace std;
+using namespace chrono;
+
+const string TARGET = "ABCDEFGHIJKLMNO#";
+string goalBoard = TARGET;  // TARGET or a custom goal that cannot be relabelled onto it
+
+const int INF = INT_MAX;
+const int FOUND = -1;
+
+// =============================================================================
+// STRUCTURES
+// =============================================================================
+
+/**
+ * @brief Root of a subtree searched by one thread
+ */
+struct SubtreeRoot {
+      PackedBoard board;
+      int blankPos;
+      int cost;       // g(n)
+      int heuristic;  // Manhattan distance h2(n)
+      int pruneState; // Move-pruning automaton state
+      vector<PackedBoard> path; // States from the start up to this root
+
+      SubtreeRoot(PackedBoard b, int pos, int c, int h, int ps, const vector<PackedBoard>& prefix)
+            : board(b), blankPos(pos), cost(c), heuristic(h), pruneState(ps), path(prefix) {
+            path.push_back(b);
+      }
+};
+
+/**
+ * @brief Shared state of one parallel search
+ */
+struct SearchContext {
+      PackedBoard goal;
+      TranspositionTable* table;  // nullptr when disabled
+      SolvedStateCache* cache;    // nullptr when disabled
+      const SymmetricPatternDatabase* pdb; // nullptr: Manhattan distance only
+      int threshold;
+      atomic<bool> solutionFound;
+      vector<PackedBoard> solutionPath; // Start .. last state of the found path
+      int solutionRemaining;            // Exact distance of the last state (cache hit) or 0
+
+      SearchContext() : goal(0), table(nullptr), cache(nullptr), pdb(nullptr), threshold(0),
+                        solutionFound(false), solutionRemaining(0) {}
+};
+
+/**
+ * @brief Publishes the path of the first thread that reaches the goal
+ */
+void reportSolution(SearchContext& ctx, const vector<PackedBoard>& path, int remaining) {
+      bool expected = false;
+      if (ctx.solutionFound.compare_exchange_strong(expected, true)) {
+            ctx.solutionPath = path;
+            ctx.solutionRemaining = remaining;
+      }
+}
+
+// =============================================================================
+// HEURISTIC TABLES
+// =============================================================================
+
+int manhattan[16][16];  // manhattan[tile][pos]
+int neighbors[16][4];   // neighbors[pos][move], -1 if out of bounds
+
+/**
+ * @brief Precomputes per-tile Manhattan distances and per-cell neighbours
+ */
+void buildTables() {
+      for (int tile = 0; tile < 16; tile++) {
+            int goalPos = goalBoard.find(tile == PACKED_BLANK ? '#' : (char)('A' + tile));
+            for (int pos = 0; pos < 16; pos++) {
+                  manhattan[tile][pos] = (tile == PACKED_BLANK) ? 0 :
+                        abs(pos / 4 - goalPos / 4) + abs(pos % 4 - goalPos % 4);
+            }
+      }
+      for (int pos = 0; pos < 16; pos++) {
+            for (int i = 0; i < 4; i++) neighbors[pos][i] = SuccessorTable::square(4).target(pos, i);
+      }
+}
+
+int calculateH2(PackedBoard board) {
+      int totalDistance = 0;
+      for (int pos = 0; pos < 16; pos++) {
+            totalDistance += manhattan[packedTile(board, pos)][pos];
+      }
+      return totalDistance;
+}
+
+// =============================================================================
+// DEPTH-FIRST SEARCH
+// =============================================================================
+
+/**
+ * @brief Cost-bounded DFS from one node
+ * @return FOUND if the goal was reached within the threshold, otherwise the
+ *         smallest f(n) that exceeded it (the next threshold candidate)
+ */
+int dfs(PackedBoard board, int blankPos, int cost, int h2, int pruneState,
+        SearchContext& ctx, vector<PackedBoard>& path, long long& nodesExpanded) {
+      if (ctx.solutionFound.load(memory_order_relaxed)) return INF;
+
+      // Exact distances from earlier solves give perfect pruning
+      int exact;
+      if (ctx.cache && ctx.cache->lookup(board, exact)) {
+            if (cost + exact > ctx.threshold) return cost + exact;
+            path.push_back(board);
+            reportSolution(ctx, path, exact);
+            path.pop_back();
+            return FOUND;
+      }
+
+      // The pattern database and the table may know stronger (still admissible) bounds than h2
+      int heuristic = h2;
+      if (ctx.pdb) heuristic = max(heuristic, ctx.pdb->estimate(board));
+      int stored;
+      if (ctx.table && ctx.table->probe(board, stored) && stored > heuristic) {
+            heuristic = stored;
+      }
+
+      int f = cost + heuristic;
+      if (f > ctx.threshold) return f;
+
+      path.push_back(board);
+      if (board == ctx.goal) {
+            reportSolution(ctx, path, 0);
+            path.pop_back();
+            return FOUND;
+      }
+
+      nodesExpanded++;
+
+      int minNext = INF;
+      int lowerBound = INF;  // min over all neighbours of 1 + lower bound
+
+      for (int i = 0; i < 4; i++) {
+            int newPos = neighbors[blankPos][i];
+            if (newPos < 0) continue;
+
+            int tile = packedTile(board, newPos);
+            int childH2 = h2 - manhattan[tile][newPos] + manhattan[tile][blankPos];
+
+            // Pruned moves are not searched here, but still bound the distance
+            int nextPruneState = MOVE_PRUNING_NEXT[pruneState][i];
+            if (nextPruneState < 0) {
+                  lowerBound = min(lowerBound, 1 + childH2);
+                  continue;
+            }
+
+            PackedBoard child = packedMove(board, blankPos, newPos);
+            int result = dfs(child, newPos, cost + 1, childH2, nextPruneState, ctx, path, nodesExpanded);
+            if (result == FOUND) {
+                  path.pop_back();
+                  return FOUND;
+            }
+
+            minNext = min(minNext, result);
+            if (result != INF) lowerBound = min(lowerBound, result - cost);
+      }
+
+      // Every path to the goal through this node costs at least lowerBound
+      if (ctx.table && !ctx.solutionFound.load(memory_order_relaxed)
+          && lowerBound != INF && lowerBound > heuristic) {
+            ctx.table->store(board, lowerBound, ctx.threshold - cost);
+      }
+
+      path.pop_back();
+      return minNext;
+}
+
+// =============================================================================
+// PARALLEL IDA* ALGORITHM WITH H2
+// =============================================================================
+
+/**
+ * @brief Expands the root breadth-first until there are enough subtrees
+ * @return The root that is the goal if it is met during the expansion, else -1
+ */
+int buildSubtreeRoots(PackedBoard start, PackedBoard goal, int minRoots, vector<SubtreeRoot>& roots) {
+      roots.clear();
+      roots.push_back(SubtreeRoot(start, packedBlankPos(start), 0, calculateH2(start),
+                                  MOVE_PRUNING_START, vector<PackedBoard>()));
+
+      // A few levels are enough; deeper levels only repeat work every iteration
+      for (int depth = 0; depth < 8 && (int)roots.size() < minRoots; depth++) {
+            vector<SubtreeRoot> nextLevel;
+            for (int r = 0; r < (int)roots.size(); r++) {
+                  const SubtreeRoot& node = roots[r];
+                  if (node.board == goal) return r;
+
+                  for (int i = 0; i < 4; i++) {
+                        int nextPruneState = MOVE_PRUNING_NEXT[node.pruneState][i];
+                        if (nextPruneState < 0) continue;
+
+                        int newPos = neighbors[node.blankPos][i];
+                        if (newPos < 0) continue;
+
+                        int tile = packedTile(node.board, newPos);
+                        int h = node.heuristic - manhattan[tile][newPos] + manhattan[tile][node.blankPos];
+                        nextLevel.push_back(SubtreeRoot(packedMove(node.board, node.blankPos, newPos),
+                                                        newPos, node.cost + 1, h, nextPruneState, node.path));
+                  }
+            }
+            roots.swap(nextLevel);
+      }
+      return -1;
+}
+
+int parallelIDAStarH2(string start, int numThreads, TranspositionTable* table,
+                      SolvedStateCache* cache, const SymmetricPatternDatabase* pdb, bool printStats) {
+      SearchContext ctx;
+      ctx.goal = packBoard(goalBoard);
+      ctx.table = table;
+      ctx.cache = cache;
+      ctx.pdb = pdb;
+
+      PackedBoard startBoard = packBoard(start);
+      if (startBoard == ctx.goal) return 0;
+
+      int cached;
+      if (cache && cache->lookup(startBoard, cached)) return cached;
+
+      vector<SubtreeRoot> roots;
+      int shallowGoal = buildSubtreeRoots(startBoard, ctx.goal, numThreads * 16, roots);
+      if (shallowGoal >= 0) {
+            if (cache) cache->recordPath(roots[shallowGoal].path);
+            return roots[shallowGoal].cost;
+      }
+
+      ctx.threshold = calculateH2(startBoard);
+      if (pdb) ctx.threshold = max(ctx.threshold, pdb->estimate(startBoard));
+      long long totalNodes = 0;
+
+      while (true) {
+            int nextThreshold = INF;
+            long long iterationNodes = 0;
+
+            #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 1) \
+                  reduction(min: nextThreshold) reduction(+: iterationNodes)
+            for (int idx = 0; idx < (int)roots.size(); idx++) {
+                  const SubtreeRoot& root = roots[idx];
+                  vector<PackedBoard> path(root.path.begin(), root.path.end() - 1);
+                  int result = dfs(root.board, root.blankPos, root.cost, root.heuristic,
+                                   root.pruneState, ctx, path, iterationNodes);
+                  if (result != FOUND) nextThreshold = min(nextThreshold, result);
+            }
+
+            totalNodes += iterationNodes;
+            if (printStats) {
+                  cerr << "Threshold " << ctx.threshold << ": " << iterationNodes << " nodes" << endl;
+            }
+
+            // Every cost below the threshold was ruled out by the previous iterations
+            if (ctx.solutionFound) break;
+            if (nextThreshold == INF) return -1;
+
+            ctx.threshold = nextThreshold;
+            if (table) table->newIteration();
+      }
+
+      // Every state on the optimal path now has a known exact distance
+      if (cache) cache->recordPath(ctx.solutionPath, ctx.solutionRemaining);
+
+      if (printStats) {
+            cerr << "Nodes expanded: " << totalNodes << endl;
+            if (table) table->printStats(cerr);
+            if (cache) cache->printStats(cerr);
+            if (pdb) cerr << "PDB bytes: " << pdb->bytes() << endl;
+      }
+      return ctx.threshold;
+}
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+int main(int argc, char* argv[]) {
+      string puzzle, goal;
+      cin >> puzzle;
+      if (!(cin >> goal)) goal = TARGET;
+
+      if (!sameTiles(puzzle, goal, TARGET)) {
+            cerr << "Error: expected 4x4 boards such as ABCDEFGHIJKLMNO#" << endl;
+            return 1;
+      }
+      // Parity test: IDA* never terminates on the other half of the permutations
+      if (!goalReachable(puzzle, goal, 4)) {
+            cout << -1 << endl;
+            return 0;
+      }
+      // Corner goals keep the canonical tables; the others are searched as given
+      if (goalBlankInCorner(goal, 4)) {
+            relabelToCanonical(puzzle, goal, TARGET, 4, puzzle);
+      } else {
+            goalBoard = goal;
+      }
+
+      int numThreads = omp_get_max_threads();
+      size_t tableMB = 64;
+      string cachePath;
+      string heuristic = "manhattan";
+      bool printStats = false;
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--tt-mb") == 0 && i + 1 < argc) {
+                  tableMB = atol(argv[++i]);
+            } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                  cachePath = argv[++i];
+            } else if (strcmp(argv[i], "--heuristic") == 0 && i + 1 < argc) {
+                  heuristic = argv[++i];
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            } else {
+                  numThreads = atoi(argv[i]);
+            }
+      }
+
+      buildTables();
+
+      TranspositionTable* table = nullptr;
+      if (tableMB > 0) table = new TranspositionTable(tableMB * 1024 * 1024);
+
+      // Both hold distances to TARGET
+      if (goalBoard != TARGET && (!cachePath.empty() || heuristic == "pdb")) {
+            cerr << "Error: --cache and --heuristic pdb need a goal with '#' in a corner" << endl;
+            return 1;
+      }
+
+      SolvedStateCache* cache = nullptr;
+      if (!cachePath.empty()) cache = new SolvedStateCache(cachePath, 1 << 20);
+
+      SymmetricPatternDatabase* pdb = nullptr;
+      if (heuristic == "pdb") {
+            pdb = new SymmetricPatternDatabase();
+      } else if (heuristic != "manhattan") {
+            cerr << "Error: unknown heuristic " << heuristic << " (use manhattan or pdb)" << endl;
+            return 1;
+      }
+
+      auto startTime = high_resolution_clock::now();
+      int solution = parallelIDAStarH2(puzzle, numThreads, table, cache, pdb, printStats);
+      auto endTime = high_resolution_clock::now();
+
+      double timeMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
+
+      cout << solution << endl;
+      if (printStats) cerr << "Time: " << timeMs << " ms" << endl;
+
+      delete pdb;
+      delete cache;
+      delete table;
+      return 0;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file perf_counters.h
+ * @brief Optional per-phase, per-thread hardware counters via perf_event_open
+ *
+ * Answers "is this phase memory-bound or compute-bound?": for every search
+ * phase and thread it accumulates wall time and, when the kernel allows it,
+ * cycles, instructions, last-level-cache misses, dTLB misses, branch misses
+ * and task-clock (CPU time of the thread), and prints them per expanded node.
+ *
+ * Each thread opens its own counter group the first time it measures
+ * something (perf counts the calling thread only) and reads the whole group
+ * with a single read(). Events the machine does not support (typically all
+ * hardware events inside a VM or container) are reported as n/a; if none
+ * can be opened the report degrades to timing only.
+ *
+ * Usage:
+ *   PerfProfile profile(enabled, numThreads);
+ *   int expandPhase = profile.addPhase("expand");   // before any parallel region
+ *   ...
+ *   { PerfProfile::Scope scope(profile, expandPhase, omp_get_thread_num()); ... scope.addNodes(n); }
+ *   profile.print(cerr);
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+enum PerfEvent {
+      PERF_CYCLES,
+      PERF_INSTRUCTIONS,
+      PERF_LLC_MISSES,
+      PERF_DTLB_MISSES,
+      PERF_BRANCH_MISSES,
+      PERF_TASK_CLOCK,   // nanoseconds of CPU time (software event)
+      PERF_EVENT_COUNT
+};
+
+/**
+ * @brief Counter group of the calling thread
+ */
+class ThreadPerfCounters {
+public:
+      ThreadPerfCounters() : leader(-1), members(0) {
+            static const uint32_t types[PERF_EVENT_COUNT] = {
+                  PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                  PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE
+            };
+            static const uint64_t configs[PERF_EVENT_COUNT] = {
+                  PERF_COUNT_HW_CPU_CYCLES,
+                  PERF_COUNT_HW_INSTRUCTIONS,
+                  PERF_COUNT_HW_CACHE_MISSES,
+                  PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                  PERF_COUNT_HW_BRANCH_MISSES,
+                  PERF_COUNT_SW_TASK_CLOCK
+            };
+
+            openError = 0;
+            for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+                  slot[e] = -1;
+                  fds[e] = -1;
+
+                  perf_event_attr attr;
+                  memset(&attr, 0, sizeof(attr));
+                  attr.size = sizeof(attr);
+                  attr.type = types[e];
+                  attr.config = configs[e];
+                  attr.exclude_kernel = 1;
+                  attr.exclude_hv = 1;
+                  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                                   | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                  int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+                  if (fd < 0) {
+                        if (openError == 0) openError = errno;
+                        continue;
+                  }
+                  if (leader < 0) leader = fd;
+                  fds[e] = fd;
+                  slot[e] = members++;
+            }
+      }
+
+      ~ThreadPerfCounters() {
+            for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+                  if (fds[e] >= 0) close(fds[e]);
+            }
+      }
+
+      bool isAvailable(int event) const { return slot[event] >= 0; }
+
+      bool anyAvailable() const { return members > 0; }
+
+      int error() const { return openError; }
+
+      /**
+       * @brief Reads every event of the group (scaled if the group was multiplexed)
+       */
+      void read(uint64_t values[PERF_EVENT_COUNT]) const {
+            memset(values, 0, sizeof(uint64_t) * PERF_EVENT_COUNT);
+            if (leader < 0) return;
+
+            uint64_t buffer[3 + PERF_EVENT_COUNT];
+            if (::read(leader, buffer, sizeof(buffer)) < (ssize_t)(3 * sizeof(uint64_t))) return;
+
+            uint64_t enabled = buffer[1];
+            uint64_t running = buffer[2];
+            double scale = (running > 0 && running < enabled) ? (double)enabled / running : 1.0;
+            for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+                  if (slot[e] >= 0) values[e] = (uint64_t)(buffer[3 + slot[e]] * scale);
+            }
+      }
+
+      /**
+       * @brief Counters of the calling thread, opened on first use
+       */
+      static ThreadPerfCounters& current() {
+            static thread_local ThreadPerfCounters counters;
+            return counters;
+      }
+
+private:
+      int fds[PERF_EVENT_COUNT];
+      int slot[PERF_EVENT_COUNT];  // Position in the group read, -1 if unavailable
+      int leader;
+      int members;
+      int openError;
+};
+
+/**
+ * @brief Accumulated measurements per (phase, thread)
+ */
+class PerfProfile {
+public:
+      /**
+       * @param enabled When false every call is a no-op
+       * @param maxThreads Thread ids passed to Scope must be below this
+       */
+      PerfProfile(bool enabled, int maxThreads) : active(enabled), numThreads(maxThreads) {}
+
+      /**
+       * @brief Registers a phase; call before measuring (not thread-safe)
+       */
+      int addPhase(const std::string& name) {
+            phaseNames.push_back(name);
+            samples.resize(phaseNames.size() * numThreads);
+            return phaseNames.size() - 1;
+      }
+
+      bool isEnabled() const { return active; }
+
+      /**
+       * @brief Credits expanded nodes to a phase after it was measured
+       *        (e.g. a sort is normalised by the nodes of the batch it prepared)
+       */
+      void addNodes(int phase, int thread, long long nodes) {
+            if (active) samples[phase * numThreads + thread].nodes += nodes;
+      }
+
+private:
+      struct Sample {
+            double seconds;
+            long long nodes;
+            uint64_t counts[PERF_EVENT_COUNT];
+            bool used;
+            char padding[64];  // Threads update neighbouring samples
+
+            Sample() : seconds(0), nodes(0), used(false) {
+                  memset(counts, 0, sizeof(counts));
+            }
+      };
+
+public:
+      /**
+       * @brief Measures the enclosing block on the calling thread
+       */
+      class Scope {
+      public:
+            Scope(PerfProfile& p, int phase, int thread)
+                  : profile(p), sample(nullptr) {
+                  if (!profile.active) return;
+                  sample = &profile.samples[phase * profile.numThreads + thread];
+                  ThreadPerfCounters::current().read(startCounts);
+                  startTime = std::chrono::steady_clock::now();
+            }
+
+            ~Scope() {
+                  if (!sample) return;
+                  auto endTime = std::chrono::steady_clock::now();
+                  uint64_t endCounts[PERF_EVENT_COUNT];
+                  ThreadPerfCounters::current().read(endCounts);
+                  sample->seconds += std::chrono::duration<double>(endTime - startTime).count();
+                  for (int e = 0; e < PERF_EVENT_COUNT; e++) sample->counts[e] += endCounts[e] - startCounts[e];
+                  sample->used = true;
+            }
+
+            /**
+             * @brief Credits expanded nodes to this phase and thread
+             */
+            void addNodes(long long nodes) {
+                  if (sample) sample->nodes += nodes;
+            }
+
+      private:
+            PerfProfile& profile;
+            Sample* sample;
+            uint64_t startCounts[PERF_EVENT_COUNT];
+            std::chrono::steady_clock::time_point startTime;
+      };
+
+      /**
+       * @brief Prints one line per (phase, thread) and a total per phase
+       */
+      void print(std::ostream& out) const {
+            if (!active) return;
+
+            const ThreadPerfCounters& counters = ThreadPerfCounters::current();
+            if (!counters.anyAvailable()) {
+                  out << "Performance counters unavailable (" << strerror(counters.error())
+                      << "); timing only" << std::endl;
+            } else if (!counters.isAvailable(PERF_CYCLES)) {
+                  out << "Hardware counters unavailable (" << strerror(counters.error())
+                      << "); software counters and timing only" << std::endl;
+            }
+
+            out << std::left << std::setw(12) << "phase" << std::setw(8) << "thread"
+                << std::right << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms"
+                << std::setw(12) << "nodes" << std::setw(12) << "cyc/node" << std::setw(12) << "ins/node"
+                << std::setw(8) << "IPC" << std::setw(12) << "LLC/node" << std::setw(12) << "dTLB/node"
+                << std::setw(12) << "brmis/node" << std::endl;
+
+            for (size_t phase = 0; phase < phaseNames.size(); phase++) {
+                  Sample total;
+                  int threadsUsed = 0;
+                  for (int thread = 0; thread < numThreads; thread++) {
+                        const Sample& s = samples[phase * numThreads + thread];
+                        if (!s.used) continue;
+                        printRow(out, phaseNames[phase], std::to_string(thread), s, counters);
+                        total.seconds += s.seconds;
+                        total.nodes += s.nodes;
+                        for (int e = 0; e < PERF_EVENT_COUNT; e++) total.counts[e] += s.counts[e];
+                        threadsUsed++;
+                  }
+                  if (threadsUsed > 1) printRow(out, phaseNames[phase], "all", total, counters);
+            }
+      }
+
+private:
+      static void printRow(std::ostream& out, const std::string& phase, const std::string& thread,
+                           const Sample& s, const ThreadPerfCounters& counters) {
+            double nodes = s.nodes > 0 ? (double)s.nodes : 1.0;
+            out << std::left << std::setw(12) << phase << std::setw(8) << thread << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(12) << s.seconds * 1000.0;
+            printValue(out, counters.isAvailable(PERF_TASK_CLOCK), s.counts[PERF_TASK_CLOCK] / 1e6);
+            out << std::setw(12) << s.nodes;
+            printValue(out, counters.isAvailable(PERF_CYCLES), s.counts[PERF_CYCLES] / nodes);
+            printValue(out, counters.isAvailable(PERF_INSTRUCTIONS), s.counts[PERF_INSTRUCTIONS] / nodes);
+            bool ipc = counters.isAvailable(PERF_CYCLES) && counters.isAvailable(PERF_INSTRUCTIONS)
+                       && s.counts[PERF_CYCLES] > 0;
+            out << std::setw(8);
+            if (ipc) out << (double)s.counts[PERF_INSTRUCTIONS] / s.counts[PERF_CYCLES];
+            else out << "n/a";
+            printValue(out, counters.isAvailable(PERF_LLC_MISSES), s.counts[PERF_LLC_MISSES] / nodes);
+            printValue(out, counters.isAvailable(PERF_DTLB_MISSES), s.counts[PERF_DTLB_MISSES] / nodes);
+            printValue(out, counters.isAvailable(PERF_BRANCH_MISSES), s.counts[PERF_BRANCH_MISSES] / nodes);
+            out << std::endl;
+            out.unsetf(std::ios::fixed);
+      }
+
+      static void printValue(std::ostream& out, bool available, double value) {
+            out << std::setw(12);
+            if (available) out << value;
+            else out << "n/a";
+      }
+
+      bool active;
+      int numThreads;
+      std::vector<std::string> phaseNames;
+      std::vector<Sample> samples;  // [phase * numThreads + thread]
+};
+
+#endif // PERF_COUNTERS_H
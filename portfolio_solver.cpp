@@ -0,0 +1,583 @@
+/**
+ * @file portfolio_solver.cpp
+ * @brief Races several optimal engines on one 4x4 puzzle and cancels the losers
+ *
+ * Which engine is fastest depends on the instance: BFS wins on short
+ * solutions, A* when its open list stays small, IDA* on deep instances where
+ * A* runs out of memory. Instead of guessing, the portfolio runs them all at
+ * once, each on its own share of the threads:
+ *
+ *   bfs       Level-synchronous BFS over packed boards (parallel expansion)
+ *   astar-h1  A* with the misplaced-tiles heuristic
+ *   astar-h2  A* with the Manhattan heuristic (high-g tie-breaking)
+ *   idastar   IDA* with Manhattan of the embeddable solver (puzzle_solver.h):
+ *             every iteration splits the root into subtrees claimed by the
+ *             engine's threads
+ *   fringe    Fringe Search (fringe_search.h) with Manhattan
+ *
+ * Every engine returns only proven-optimal lengths, so the first answer is
+ * the answer. The winner raises a shared StopToken (stop_token.h); the other
+ * engines poll it in their expansion loops and return, and the solver waits
+ * for all of them before exiting. BFS also gives up on its own once it has
+ * stored --bfs-max-states boards, and each A* once it has stored as many
+ * boards as --memory holds, so neither can exhaust memory while the others
+ * keep working.
+ *
+ * Before the race, effort_predictor.h predicts the solution length and the
+ * nodes of each engine: engines whose predicted memory exceeds --memory are
+ * not started (A*-h1 is bounded by the BFS states, Fringe by the A*-h2
+ * nodes), the engine predicted fastest gets its recommended thread count,
+ * and the BFS state limit follows the memory budget.
+ *
+ * A custom goal with the blank in a corner is relabelled onto TARGET
+ * (goal_relabel.h), which the predictor needs. Any other goal is searched as
+ * given, with Manhattan distances to its own cells and without a prediction.
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -pthread -o portfolio_solver portfolio_solver.cpp
+ *
+ * Usage:
+ *   echo BOARD [GOAL] | portfolio_solver [--threads T] [--engines LIST]
+ *                                        [--share ENGINE=K] [--memory MB] [--bfs-max-states N]
+ *                                        [--no-predict] [--stats]
+ *
+ *   --threads T          Threads split among the engines (default: all cores)
+ *   --engines LIST       Comma-separated subset (default bfs,astar-h1,astar-h2,idastar,fringe)
+ *   --share ENGINE=K     Give ENGINE exactly K threads (repeatable). Otherwise
+ *                        sequential engines get 1 thread and bfs / idastar share
+ *                        the rest (idastar first), at least 1 each. The total
+ *                        never exceeds --threads: when there are fewer threads
+ *                        than engines, the last engines of the list without a
+ *                        share are not started (never the predicted fastest,
+ *                        or idastar with --no-predict)
+ *   --memory MB          Memory budget of the race (default 2048); A*-h1 and
+ *                        A*-h2 give up once their boards would exceed it
+ *   --bfs-max-states N   Boards BFS may store before giving up (default: the budget)
+ *   --no-predict         Start every engine and split the threads evenly
+ *   --stats              Print every engine's outcome, node count and stop latency
+ *
+ * Output: the optimal length, or -1 if the board is unsolvable. If every
+ * engine gives up before an answer, nothing is printed on stdout, an error
+ * goes to stderr and the exit status is 2.
+ *
+ * Example:
+ *   echo EABCM#GDKFILNOJH | portfolio_solver --threads 8 --stats
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_set>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "packed_board.h"
+#include "goal_relabel.h"
+#include "tie_breaking.h"
+#include "fringe_search.h"
+#include "stop_token.h"
+#include "effort_predictor.h"
+#include "puzzle_solver.h"
+
+using namespace std;
+using namespace chrono;
+
+const string TARGET = "ABCDEFGHIJKLMNO#";
+
+// Goal of the race: TARGET, or a custom goal that cannot be relabelled onto it
+string goalBoard = TARGET;
+PackedBoard GOAL = packBoard(TARGET);
+int goalCell[16];  // Cell of every packed tile in goalBoard
+
+
+// Engine results below zero
+const int UNSOLVABLE = -1;
+const int CANCELLED = FringeSearch::CANCELLED;
+const int GAVE_UP = -3;
+
+// Exit status when every engine gave up (the board is solvable, the length unknown)
+const int NO_ANSWER_EXIT = 2;
+
+// Stop token polling interval (nodes, power of two minus one)
+const long long POLL_MASK = 1023;
+
+// =============================================================================
+// HEURISTICS
+// =============================================================================
+
+void setGoal(const string& goal) {
+      goalBoard = goal;
+      GOAL = packBoard(goal);
+      for (int pos = 0; pos < 16; pos++) goalCell[packedTile(GOAL, pos)] = pos;
+}
+
+int tileDistance(int tile, int pos) {
+      int home = goalCell[tile];
+      return abs(pos / 4 - home / 4) + abs(pos % 4 - home % 4);
+}
+
+int manhattan(PackedBoard board) {
+      int h = 0;
+      for (int pos = 0; pos < 16; pos++) {
+            int tile = packedTile(board, pos);
+            if (tile != PACKED_BLANK) h += tileDistance(tile, pos);
+      }
+      return h;
+}
+
+int misplaced(PackedBoard board) {
+      int h = 0;
+      for (int pos = 0; pos < 16; pos++) {
+            int tile = packedTile(board, pos);
+            if (tile != PACKED_BLANK && goalCell[tile] != pos) h++;
+      }
+      return h;
+}
+
+// String form for FringeSearch
+int manhattanString(const string& board) {
+      return manhattan(packBoard(board));
+}
+
+/**
+ * @brief Validates the input board: the 16 symbols of TARGET, each once
+ */
+bool isValidBoard(const string& board) {
+      if (board.length() != 16) return false;
+      string sorted = board;
+      string expected = TARGET;
+      sort(sorted.begin(), sorted.end());
+      sort(expected.begin(), expected.end());
+      return sorted == expected;
+}
+
+/**
+ * @brief Calls visit(child, childBlank, childPruneState) for every non-pruned move
+ */
+template <class Visitor>
+void forEachMove(PackedBoard board, int blank, int pruneState, Visitor visit) {
+      const SuccessorTable& moves = SuccessorTable::square(4);
+      for (int k = 0; k < moves.count(blank); k++) {
+            int nextState = MOVE_PRUNING_NEXT[pruneState][moves.move(blank, k)];
+            if (nextState < 0) continue;
+            int newPos = moves.neighbor(blank, k);
+            visit(packedMove(board, blank, newPos), newPos, nextState);
+      }
+}
+
+// =============================================================================
+// ENGINES
+// =============================================================================
+
+/**
+ * @brief Level-synchronous BFS; each level is expanded by `threads` threads
+ *        and merged into the visited set by the calling thread
+ */
+int runBFS(PackedBoard start, int threads, const StopToken& stop, long long& nodes, size_t maxStates) {
+      if (start == GOAL) return 0;
+      unordered_set<PackedBoard> visited;
+      visited.insert(start);
+      vector<PackedBoard> frontier(1, start);
+      vector<vector<PackedBoard> > produced(threads);
+      atomic<bool> cancelled(false);
+
+      for (int depth = 1; !frontier.empty(); depth++) {
+            // Expansion: visited is only read here, so threads share it safely
+            vector<thread> workers;
+            size_t chunk = (frontier.size() + threads - 1) / threads;
+            for (int t = 0; t < threads; t++) {
+                  workers.push_back(thread([&, t]() {
+                        vector<PackedBoard>& out = produced[t];
+                        out.clear();
+                        size_t end = min(frontier.size(), (t + 1) * chunk);
+                        for (size_t i = t * chunk; i < end; i++) {
+                              if ((i & POLL_MASK) == 0 && stop.stopRequested()) {
+                                    cancelled = true;
+                                    return;
+                              }
+                              PackedBoard board = frontier[i];
+                              int blank = packedBlankPos(board);
+                              forEachMove(board, blank, MOVE_PRUNING_START, [&](PackedBoard child, int, int) {
+                                    if (!visited.count(child)) out.push_back(child);
+                              });
+                        }
+                  }));
+            }
+            for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+            nodes += frontier.size();
+            if (cancelled) return CANCELLED;
+
+            // Merge: duplicates between threads are removed by the insert
+            vector<PackedBoard> next;
+            for (int t = 0; t < threads; t++) {
+                  for (size_t i = 0; i < produced[t].size(); i++) {
+                        PackedBoard child = produced[t][i];
+                        if (child == GOAL) return depth;
+                        if (visited.insert(child).second) next.push_back(child);
+                  }
+            }
+            if (visited.size() > maxStates) return GAVE_UP;
+            frontier.swap(next);
+      }
+      return UNSOLVABLE;
+}
+
+struct AStarState {
+      PackedBoard board;
+      int blankPos;
+      int cost;
+      int heuristic;
+      int pruneState;
+      long long order;
+
+      int f() const { return cost + heuristic; }
+};
+
+/**
+ * @brief Sequential A* over packed boards with the given heuristic; gives
+ *        up once it has stored more than maxStates boards
+ */
+int runAStar(PackedBoard start, int (*h)(PackedBoard), const StopToken& stop, long long& nodes, size_t maxStates) {
+      priority_queue<AStarState, vector<AStarState>, TieBreakCompare<AStarState> > open(
+            (TieBreakCompare<AStarState>(TIE_HIGH_G)));
+      unordered_map<PackedBoard, int> bestCost;
+      long long generated = 0;
+
+      AStarState root = {start, packedBlankPos(start), 0, h(start), MOVE_PRUNING_START, generated++};
+      open.push(root);
+      bestCost[start] = 0;
+
+      while (!open.empty()) {
+            AStarState current = open.top();
+            open.pop();
+            if (current.board == GOAL) return current.cost;
+            if (current.cost > bestCost[current.board]) continue;  // stale entry
+            if ((++nodes & POLL_MASK) == 0 && stop.stopRequested()) return CANCELLED;
+
+            forEachMove(current.board, current.blankPos, current.pruneState,
+                        [&](PackedBoard child, int newPos, int nextState) {
+                  int cost = current.cost + 1;
+                  unordered_map<PackedBoard, int>::iterator found = bestCost.find(child);
+                  if (found != bestCost.end() && found->second <= cost) return;
+                  bestCost[child] = cost;
+                  AStarState next = {child, newPos, cost, h(child), nextState, generated++};
+                  open.push(next);
+            });
+            if (bestCost.size() > maxStates) return GAVE_UP;
+      }
+      return UNSOLVABLE;
+}
+
+/**
+ * @brief IDA* of the embeddable solver on `threads` threads
+ */
+int runIDAStar(const string& board, int threads, const shared_ptr<StopToken>& stop, long long& nodes) {
+      SolveOptions options;
+      options.algorithm = SOLVE_IDASTAR;
+      options.threads = threads;
+      options.stop = stop;
+      if (goalBoard != TARGET) options.goal = goalBoard;
+      SolveResult result = PuzzleSolver::run(board, options);
+      nodes = result.nodesExpanded;
+      if (result.status == SOLVE_SOLVED) return result.moves;
+      return result.status == SOLVE_CANCELLED ? CANCELLED : UNSOLVABLE;
+}
+
+// =============================================================================
+// PORTFOLIO
+// =============================================================================
+
+struct Engine {
+      string name;
+      bool parallel;  // Can use more than one thread
+      int threads;
+      int result;
+      long long nodes;
+      double ms;      // Run time since the race started
+};
+
+class Portfolio {
+public:
+      Portfolio(vector<Engine>& list, size_t maxBfsStates, size_t maxAStarStates)
+            : engines(list), bfsMaxStates(maxBfsStates), astarMaxStates(maxAStarStates), stop(make_shared<StopToken>()), winner(-1), stopMs(-1) {}
+
+      /**
+       * @brief Runs every engine on its own thread(s) until one of them proves an answer
+       * @return index of the winning engine, or -1 if none succeeded
+       */
+      int race(const string& board) {
+            start = steady_clock::now();
+            vector<thread> runners;
+            for (size_t i = 0; i < engines.size(); i++) {
+                  runners.push_back(thread(&Portfolio::runEngine, this, i, board));
+            }
+            for (size_t i = 0; i < runners.size(); i++) runners[i].join();
+            return winner;
+      }
+
+      /**
+       * @brief Time from the start of the race to the winner's stop request
+       */
+      double stopTimeMs() const { return stopMs; }
+
+private:
+      void runEngine(size_t index, string board) {
+            Engine& engine = engines[index];
+            PackedBoard packed = packBoard(board);
+            engine.nodes = 0;
+
+            if (engine.name == "bfs") {
+                  engine.result = runBFS(packed, engine.threads, *stop, engine.nodes, bfsMaxStates);
+            } else if (engine.name == "astar-h1") {
+                  engine.result = runAStar(packed, misplaced, *stop, engine.nodes, astarMaxStates);
+            } else if (engine.name == "astar-h2") {
+                  engine.result = runAStar(packed, manhattan, *stop, engine.nodes, astarMaxStates);
+            } else if (engine.name == "idastar") {
+                  engine.result = runIDAStar(board, engine.threads, stop, engine.nodes);
+            } else {
+                  FringeSearch fringe(4, goalBoard, manhattanString);
+                  fringe.setStopToken(stop.get());
+                  engine.result = fringe.solve(board);
+                  engine.nodes = fringe.expanded();
+            }
+            engine.ms = duration<double, milli>(steady_clock::now() - start).count();
+
+            if (engine.result >= 0) {
+                  int expected = -1;
+                  if (winner.compare_exchange_strong(expected, (int)index)) {
+                        stopMs = engine.ms;
+                        stop->requestStop();
+                  }
+            }
+      }
+
+      vector<Engine>& engines;
+      size_t bfsMaxStates;
+      size_t astarMaxStates;
+      shared_ptr<StopToken> stop;  // Shared with the idastar engine's solver
+      atomic<int> winner;
+      double stopMs;
+      steady_clock::time_point start;
+};
+
+const char* outcome(int result) {
+      if (result >= 0) return "solved";
+      if (result == CANCELLED) return "cancelled";
+      if (result == GAVE_UP) return "gave up";
+      return "unsolvable";
+}
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+int main(int argc, char* argv[]) {
+      int numThreads = max(1u, thread::hardware_concurrency());
+      string engineList = "bfs,astar-h1,astar-h2,idastar,fringe";
+      vector<pair<string, int> > shares;
+      double memoryMB = 2048;
+      size_t bfsMaxStates = 0;
+      bool predict = true;
+      bool printStats = false;
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                  numThreads = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--engines") == 0 && i + 1 < argc) {
+                  engineList = argv[++i];
+            } else if (strcmp(argv[i], "--share") == 0 && i + 1 < argc) {
+                  string share = argv[++i];
+                  size_t eq = share.find('=');
+                  if (eq == string::npos || atoi(share.c_str() + eq + 1) < 1) {
+                        cerr << "Error: --share expects ENGINE=K with K >= 1" << endl;
+                        return 1;
+                  }
+                  shares.push_back(make_pair(share.substr(0, eq), atoi(share.c_str() + eq + 1)));
+            } else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc) {
+                  memoryMB = atof(argv[++i]);
+            } else if (strcmp(argv[i], "--bfs-max-states") == 0 && i + 1 < argc) {
+                  bfsMaxStates = strtoull(argv[++i], 0, 10);
+            } else if (strcmp(argv[i], "--no-predict") == 0) {
+                  predict = false;
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  printStats = true;
+            } else {
+                  cerr << "Usage: " << argv[0] << " [--threads T] [--engines LIST] [--share ENGINE=K]"
+                       << " [--memory MB] [--bfs-max-states N] [--no-predict] [--stats] < board" << endl;
+                  return 1;
+            }
+      }
+      if (numThreads < 1) numThreads = 1;
+      double memoryBytes = memoryMB * 1048576.0;
+      if (bfsMaxStates == 0) bfsMaxStates = (size_t)(memoryBytes / EFFORT_BFS_BYTES_PER_STATE);
+      size_t astarMaxStates = (size_t)(memoryBytes / EFFORT_ASTAR_BYTES_PER_NODE);
+
+      // Board
+      string start, goal;
+      if (!(cin >> start) || !isValidBoard(start)) {
+            cerr << "Error: expected a 4x4 board such as ABCDEFGHIJKLMNO#" << endl;
+            return 1;
+      }
+      if (!(cin >> goal)) goal = TARGET;
+      if (!sameTiles(start, goal, TARGET)) {
+            cerr << "Error: goal must use the tiles of " << TARGET << endl;
+            return 1;
+      }
+      if (!goalReachable(start, goal, 4)) {
+            cout << -1 << endl;
+            return 0;
+      }
+      // The predictor only knows TARGET: corner goals are relabelled onto it
+      if (goalBlankInCorner(goal, 4)) {
+            relabelToCanonical(start, goal, TARGET, 4, start);
+            setGoal(TARGET);
+      } else {
+            setGoal(goal);
+            predict = false;
+      }
+
+      // Engines and thread shares
+      vector<Engine> engines;
+      istringstream names(engineList);
+      string name;
+      while (getline(names, name, ',')) {
+            if (name != "bfs" && name != "astar-h1" && name != "astar-h2" && name != "idastar" && name != "fringe") {
+                  cerr << "Error: unknown engine " << name << endl;
+                  return 1;
+            }
+            Engine engine = {name, name == "bfs" || name == "idastar", 0, CANCELLED, 0, 0};
+            engines.push_back(engine);
+      }
+      if (engines.empty()) {
+            cerr << "Error: no engines selected" << endl;
+            return 1;
+      }
+
+      // Predicted effort: drop engines that would not fit, size the likely winner
+      EffortPrediction prediction;
+      EffortChoice choice;
+      vector<string> skipped;
+      if (predict) {
+            EffortPredictor predictor(4);
+            prediction = predictor.predict(start);
+            choice = EffortPredictor::choose(prediction, numThreads, memoryBytes);
+            vector<Engine> kept;
+            for (size_t i = 0; i < engines.size(); i++) {
+                  const string& engine = engines[i].name;
+                  double bytes = 0;
+                  if (engine == "bfs") bytes = prediction.bfsStates * EFFORT_BFS_BYTES_PER_STATE;
+                  else if (engine == "astar-h1") bytes = prediction.bfsStates * EFFORT_ASTAR_BYTES_PER_NODE;
+                  else if (engine != "idastar") bytes = prediction.astarNodes * EFFORT_ASTAR_BYTES_PER_NODE;
+                  if (bytes > memoryBytes) skipped.push_back(engine);
+                  else kept.push_back(engines[i]);
+            }
+            if (kept.empty()) {
+                  cerr << "Error: every selected engine is predicted to exceed " << memoryMB << " MB" << endl;
+                  return 1;
+            }
+            engines.swap(kept);
+      }
+      for (size_t s = 0; s < shares.size(); s++) {
+            bool known = false;
+            for (size_t i = 0; i < engines.size(); i++) {
+                  if (engines[i].name != shares[s].first) continue;
+                  engines[i].threads = engines[i].parallel ? shares[s].second : 1;
+                  known = true;
+            }
+            if (!known && find(skipped.begin(), skipped.end(), shares[s].first) == skipped.end()) {
+                  cerr << "Error: --share names an engine that is not running: " << shares[s].first << endl;
+                  return 1;
+            }
+      }
+
+      // Every engine needs a thread of the budget: without enough of them the
+      // last engines of the list without a share are not started (never the
+      // predicted fastest, or idastar without a prediction)
+      string kept = predict ? choice.engine : "idastar";
+      int needed = 0;
+      for (size_t i = 0; i < engines.size(); i++) needed += max(1, engines[i].threads);
+      vector<string> idle;
+      for (size_t i = engines.size(); i-- > 0 && needed > numThreads;) {
+            if (engines[i].threads > 0 || engines[i].name == kept) continue;
+            idle.insert(idle.begin(), engines[i].name);
+            engines.erase(engines.begin() + i);
+            needed--;
+      }
+      if (needed > numThreads) {
+            cerr << "Error: the engines need " << needed << " threads but --threads is " << numThreads << endl;
+            return 1;
+      }
+
+      int remaining = numThreads, parallelEngines = 0;
+      for (size_t i = 0; i < engines.size(); i++) {
+            if (!engines[i].parallel && engines[i].threads == 0) engines[i].threads = 1;
+            if (engines[i].threads > 0) remaining -= engines[i].threads;
+            else parallelEngines++;
+      }
+      for (size_t i = 0; predict && i < engines.size(); i++) {
+            if (engines[i].name != choice.engine || engines[i].threads > 0) continue;
+            engines[i].threads = max(1, min(choice.threads, remaining - (parallelEngines - 1)));
+            remaining -= engines[i].threads;
+            parallelEngines--;
+      }
+      // idastar is listed after bfs but gets the odd thread first
+      for (int pass = 0; pass < 2; pass++) {
+            for (size_t i = 0; i < engines.size(); i++) {
+                  if (engines[i].threads > 0 || (pass == 0) != (engines[i].name == "idastar")) continue;
+                  int share = (remaining + parallelEngines - 1) / parallelEngines;
+                  engines[i].threads = share;
+                  remaining -= share;
+                  parallelEngines--;
+            }
+      }
+
+      Portfolio portfolio(engines, bfsMaxStates, astarMaxStates);
+      int winner = portfolio.race(start);
+
+      if (printStats) {
+            if (predict) {
+                  cerr << "Predicted: depth " << (prediction.exactDepth ? "=" : "") << prediction.depth
+                       << ", nodes bfs " << setprecision(3) << prediction.bfsNodes << " astar-h2 "
+                       << prediction.astarNodes << " idastar " << prediction.idaNodes << ", best "
+                       << choice.engine << " on " << choice.threads << " threads" << endl;
+                  for (size_t i = 0; i < skipped.size(); i++) {
+                        cerr << setw(9) << skipped[i] << ": skipped, predicted to exceed " << (long long)memoryMB << " MB" << endl;
+                  }
+            }
+            for (size_t i = 0; i < idle.size(); i++) {
+                  cerr << setw(9) << idle[i] << ": skipped, no thread left of " << numThreads << endl;
+            }
+            cerr << fixed << setprecision(2);
+            cerr << "Winner: " << (winner >= 0 ? engines[winner].name : "none")
+                 << " after " << portfolio.stopTimeMs() << " ms" << endl;
+            for (size_t i = 0; i < engines.size(); i++) {
+                  const Engine& engine = engines[i];
+                  cerr << setw(9) << engine.name << ": " << setw(10) << outcome(engine.result)
+                       << ", threads " << engine.threads << ", nodes " << setw(10) << engine.nodes
+                       << ", " << engine.ms << " ms";
+                  if ((int)i != winner && winner >= 0 && engine.result == CANCELLED) {
+                        cerr << " (stopped " << engine.ms - portfolio.stopTimeMs() << " ms after the winner)";
+                  }
+                  cerr << endl;
+            }
+      }
+      if (winner < 0) {
+            cerr << "Error: no answer, every engine gave up (raise --memory or --bfs-max-states)" << endl;
+            return NO_ANSWER_EXIT;
+      }
+      cout << engines[winner].result << endl;
+      return 0;
+}
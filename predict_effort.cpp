@@ -0,0 +1,103 @@
+/**
+ * @file predict_effort.cpp
+ * @brief Standalone query of effort_predictor.h: predicted nodes and engine choice
+ *
+ * Reads one board per line, "board [depth]" (instance_generator.cpp format),
+ * and prints for each one
+ *
+ *   board h depth ida-nodes astar-nodes bfs-nodes engine threads memory-MB seconds
+ *
+ * where depth is the predicted solution length ("=" marks a depth found
+ * exactly by the BFS probe) and the last four columns are the recommended
+ * engine, its threads, memory budget and predicted time. When the input
+ * carries the real depth, the accuracy of the depth predictions is
+ * summarized on stderr.
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -o predict_effort predict_effort.cpp
+ *
+ * Usage:
+ *   predict_effort [--threads T] [--memory MB] [--probes P] [--seed S] < boards.txt
+ *
+ *   --threads T    Threads available to the solve (default 4)
+ *   --memory MB    Memory available to the solve (default 2048)
+ *   --probes P     Sampling probes per threshold (default 128)
+ *   --seed S       Seed of the probes (default 1)
+ *
+ * Example:
+ *   instance_generator walk 4 10 30-40 | predict_effort --threads 8
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include "effort_predictor.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+      int numThreads = 4;
+      double memoryMB = 2048;
+      int probes = 128;
+      uint64_t seed = 1;
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                  numThreads = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc) {
+                  memoryMB = atof(argv[++i]);
+            } else if (strcmp(argv[i], "--probes") == 0 && i + 1 < argc) {
+                  probes = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                  seed = strtoull(argv[++i], 0, 10);
+            } else {
+                  cerr << "Usage: " << argv[0] << " [--threads T] [--memory MB] [--probes P] [--seed S] < boards.txt"
+                       << endl;
+                  return 1;
+            }
+      }
+      if (numThreads < 1) numThreads = 1;
+      if (probes < 1) probes = 1;
+
+      int compared = 0, exact = 0, totalError = 0;
+      string line;
+      while (getline(cin, line)) {
+            istringstream tokens(line);
+            string board, depth;
+            if (!(tokens >> board)) continue;
+            int size = board.size() == 9 ? 3 : (board.size() == 16 ? 4 : (board.size() == 25 ? 5 : 0));
+            if (size == 0) {
+                  cerr << "Error: unsupported board " << board << endl;
+                  return 1;
+            }
+
+            EffortPredictor predictor(size, probes, seed);
+            EffortPrediction p = predictor.predict(board);
+            EffortChoice choice = EffortPredictor::choose(p, numThreads, memoryMB * 1048576.0);
+
+            cout << board << " " << p.heuristic << " " << (p.exactDepth ? "=" : "") << p.depth << " "
+                 << setprecision(3) << p.idaNodes << " " << p.astarNodes << " " << p.bfsNodes << " "
+                 << choice.engine << " " << choice.threads << " " << fixed << setprecision(1)
+                 << choice.memoryBytes / 1048576.0 << " " << setprecision(4) << choice.seconds << endl;
+            cout.unsetf(ios::fixed);
+
+            if (tokens >> depth && depth != "?") {
+                  int error = p.depth - atoi(depth.c_str());
+                  compared++;
+                  if (error == 0) exact++;
+                  totalError += abs(error);
+            }
+      }
+
+      if (compared > 0) {
+            cerr << "Depth predictions: " << exact << "/" << compared << " exact, mean error "
+                 << fixed << setprecision(2) << (double)totalError / compared << " moves" << endl;
+      }
+      return 0;
+}
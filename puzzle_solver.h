@@ -0,0 +1,817 @@
+/**
+ * @file puzzle_solver.h
+ * @brief Embeddable solver library: asynchronous solve with cancellation and progress
+ *
+ * The command-line solvers read one board from cin and print one integer.
+ * This header exposes the same searches to a host program:
+ *
+ *   SolveOptions options;
+ *   options.algorithm = SOLVE_IDASTAR;
+ *   options.threads = 4;
+ *   options.stop = std::make_shared<StopToken>();
+ *   options.progress = [](const SolveProgress& p) { ... };
+ *   std::future<SolveResult> result = PuzzleSolver::solve("EABCM#GDKFILNOJH", options);
+ *   ...
+ *   options.stop->requestStop();          // optional: cancel from any thread
+ *   SolveResult r = result.get();         // r.status, r.moves, r.path, r.boards, ...
+ *
+ * PuzzleSolver::run() is the synchronous form. A scheduler that moves its
+ * own threads between searches drives IDA* step by step instead:
+ *
+ *   PuzzleSolver solver(board, options);
+ *   if (solver.begin(64)) {               // root split into about 64 subtrees
+ *         // any number of threads, joining and leaving at any time:
+ *         while (solver.hasWork()) if (solver.help()) { ... solver.result() ... }
+ *   }
+ *
+ * Every help() call searches one subtree of the current iteration; the call
+ * that completes the search returns true. Boards are 3x3, 4x4 or 5x5
+ * strings ("ABC...#"); the goal defaults to the canonical one and may be any
+ * board with the same tiles: the Manhattan tables are built from its cells
+ * (goal_relabel.h). Algorithms, all optimal
+ * and all with the Manhattan heuristic where one applies:
+ *
+ *   idastar  IDA*; with threads > 1 the root is split into subtrees that
+ *            the threads claim with help() in every iteration
+ *   astar    A* with high-g tie-breaking
+ *   bfs      Breadth-first search
+ *
+ * The searches poll the stop token and the node limit every 1024 nodes and
+ * call the progress callback at most every progressInterval seconds and on
+ * every new bound (IDA* threshold, A* f value, BFS depth). The callback runs
+ * on a search thread, one call at a time; it must not block for long.
+ *
+ * The result carries the blank moves ('U', 'D', 'L', 'R' as in
+ * move_pruning_generator.cpp), the boards from start to goal and the search
+ * statistics. The stop token is shared, so it may outlive the caller's scope.
+ *
+ * A host that solves many 4x4 boards towards the canonical goal can lend
+ * IDA* its own warm tables through the options, shared by every search
+ * (as in parallel_idastar_h2_openmp.cpp):
+ *
+ *   table  lower bounds found by earlier iterations and searches
+ *          (transposition_table.h; the host decides when to call newIteration)
+ *   cache  exact distances of earlier solutions (solved_state_cache.h): a
+ *          search ends where it reaches one and the path is finished from
+ *          the cache. Recording new solutions is up to the host
+ *   pdb    row pattern database with reflected and dual lookups
+ *          (symmetry_heuristic.h), maximised with Manhattan
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef PUZZLE_SOLVER_H
+#define PUZZLE_SOLVER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "move_pruning_table.h"
+#include "successor_table.h"
+#include "goal_relabel.h"
+#include "tie_breaking.h"
+#include "stop_token.h"
+#include "packed_board.h"
+#include "transposition_table.h"
+#include "solved_state_cache.h"
+#include "symmetry_heuristic.h"
+
+enum SolveAlgorithm {
+      SOLVE_IDASTAR,
+      SOLVE_ASTAR,
+      SOLVE_BFS
+};
+
+enum SolveStatus {
+      SOLVE_SOLVED,
+      SOLVE_UNSOLVABLE,
+      SOLVE_CANCELLED,
+      SOLVE_NODE_LIMIT,
+      SOLVE_INVALID
+};
+
+inline bool parseSolveAlgorithm(const char* name, SolveAlgorithm& algorithm) {
+      if (strcmp(name, "idastar") == 0) algorithm = SOLVE_IDASTAR;
+      else if (strcmp(name, "astar") == 0) algorithm = SOLVE_ASTAR;
+      else if (strcmp(name, "bfs") == 0) algorithm = SOLVE_BFS;
+      else return false;
+      return true;
+}
+
+inline const char* solveAlgorithmName(SolveAlgorithm algorithm) {
+      static const char* names[] = {"idastar", "astar", "bfs"};
+      return names[algorithm];
+}
+
+inline const char* solveStatusName(SolveStatus status) {
+      static const char* names[] = {"solved", "unsolvable", "cancelled", "node limit", "invalid"};
+      return names[status];
+}
+
+struct SolveProgress {
+      long long nodes;  // Nodes expanded so far
+      int bound;        // Current IDA* threshold, A* f value or BFS depth
+      double seconds;   // Since the search started
+};
+
+struct SolveOptions {
+      SolveAlgorithm algorithm;
+      std::string goal;                  // Empty: canonical goal
+      int threads;                       // IDA* only
+      long long maxNodes;                // 0: no limit
+      double progressInterval;           // Seconds between progress calls
+      std::shared_ptr<StopToken> stop;   // Optional
+      std::function<void(const SolveProgress&)> progress;  // Optional
+      TranspositionTable* table;         // Optional; IDA*, 4x4 canonical goal only
+      SolvedStateCache* cache;           // Optional; IDA*, 4x4 canonical goal only
+      const SymmetricPatternDatabase* pdb;  // Optional; IDA*, 4x4 canonical goal only
+
+      SolveOptions() : algorithm(SOLVE_IDASTAR), threads(1), maxNodes(0), progressInterval(0.5),
+                       table(nullptr), cache(nullptr), pdb(nullptr) {}
+};
+
+struct SolveResult {
+      SolveStatus status;
+      int moves;                         // -1 unless solved
+      std::string path;                  // Blank moves from the start
+      std::vector<std::string> boards;   // Start, ..., goal
+      long long nodesExpanded;
+      int iterations;                    // IDA* thresholds tried (1 for A* and BFS)
+      double seconds;
+      std::string error;                 // Why the input was invalid
+
+      SolveResult() : status(SOLVE_INVALID), moves(-1), nodesExpanded(0), iterations(0), seconds(0) {}
+};
+
+class PuzzleSolver {
+public:
+      /**
+       * @brief Starts the search on its own thread
+       */
+      static std::future<SolveResult> solve(const std::string& board, const SolveOptions& options = SolveOptions()) {
+            return std::async(std::launch::async, &PuzzleSolver::run, board, options);
+      }
+
+      /**
+       * @brief Searches on the calling thread (plus options.threads - 1 helpers for IDA*)
+       */
+      static SolveResult run(const std::string& board, const SolveOptions& options = SolveOptions()) {
+            PuzzleSolver solver(board, options);
+            return solver.execute();
+      }
+
+      /**
+       * @brief Checks the board and options.goal without searching
+       * @param error Output: why the board cannot be searched ("unsolvable" included)
+       */
+      static bool accepts(const std::string& board, const SolveOptions& options, std::string& error) {
+            PuzzleSolver solver(board, options);
+            if (!solver.setup()) {
+                  error = solver.outcome.status == SOLVE_UNSOLVABLE ? "unsolvable" : solver.outcome.error;
+                  return false;
+            }
+            return true;
+      }
+
+      PuzzleSolver(const std::string& board, const SolveOptions& opts = SolveOptions())
+            : options(opts), start(board), n(0), cells(0), successors(0), tables(false), exactCache(nullptr),
+              nodes(0), bound(0), stopped(false),
+              limitReached(false), startTime(std::chrono::steady_clock::now()), lastReport(0), nextSubtree(0),
+              running(0), finishedSubtrees(0), threshold(0), iterationMinimum(INT_MAX), solution(-1),
+              idaDone(true), found(false) {}
+
+      // =========================================================================
+      // STEPWISE IDA* (shared by run() and external schedulers)
+      // =========================================================================
+
+      /**
+       * @brief Validates the board and splits the root into at least `count` subtrees
+       * @return false if the result is already final (invalid, unsolvable or
+       *         solved while splitting); result() holds it
+       */
+      bool begin(size_t count) {
+            static const char names[] = {'U', 'D', 'L', 'R'};
+            if (!setup()) return false;
+
+            // All subtrees at the same depth; goals met while splitting are the shortest
+            subtrees.assign(1, Subtree());
+            subtrees[0].node = parse(start);
+            while (subtrees.size() < count) {
+                  std::vector<Subtree> next;
+                  for (size_t i = 0; i < subtrees.size(); i++) {
+                        if (subtrees[i].node.heuristic == 0) {
+                              conclude(subtrees[i].node.cost, subtrees[i].moves);
+                              return false;
+                        }
+                        for (int move = 0; move < 4; move++) {
+                              Subtree entry;
+                              if (!child(subtrees[i].node, move, entry.node)) continue;
+                              entry.moves = subtrees[i].moves + names[move];
+                              next.push_back(entry);
+                        }
+                  }
+                  subtrees.swap(next);
+            }
+
+            threshold = INT_MAX;
+            for (size_t i = 0; i < subtrees.size(); i++) {
+                  threshold = std::min(threshold, subtrees[i].node.cost + subtrees[i].node.heuristic);
+            }
+            outcome.iterations = 1;
+            idaDone = false;
+            setBound(threshold);
+            return true;
+      }
+
+      /**
+       * @brief True while the current iteration has an unclaimed subtree
+       */
+      bool hasWork() {
+            std::lock_guard<std::mutex> lock(idaMutex);
+            return !idaDone && nextSubtree < subtrees.size();
+      }
+
+      /**
+       * @brief Claims one subtree of the current iteration and searches it
+       * @return true if this call completed the search; result() is then final
+       */
+      bool help() {
+            std::unique_lock<std::mutex> lock(idaMutex);
+            if (idaDone || nextSubtree >= subtrees.size()) return false;
+            size_t index = nextSubtree++;
+            running++;
+            int limit = threshold;
+            lock.unlock();
+
+            Node node = subtrees[index].node;
+            std::string path = subtrees[index].moves;
+            long long pending = 0;
+            int value = dfs(node, limit, path, pending, found);
+            nodes += pending;
+
+            lock.lock();
+            running--;
+            finishedSubtrees++;
+            if (value == FOUND || value == ABORTED) {
+                  if (value == FOUND && !idaDone) {
+                        solution = limit;
+                        foundMoves = path;
+                        found = true;
+                  }
+                  idaDone = true;
+            } else {
+                  iterationMinimum = std::min(iterationMinimum, value);
+            }
+            if (!idaDone && finishedSubtrees == subtrees.size()) {
+                  if (options.stop && options.stop->stopRequested()) stopped = true;
+                  if (stopped || iterationMinimum == INT_MAX) {
+                        idaDone = true;
+                  } else {
+                        // Next iteration: every subtree becomes claimable again
+                        threshold = iterationMinimum;
+                        iterationMinimum = INT_MAX;
+                        nextSubtree = 0;
+                        finishedSubtrees = 0;
+                        outcome.iterations++;
+                        setBound(threshold);
+                  }
+            }
+            idaChanged.notify_all();
+            if (!idaDone || running > 0) return false;
+            conclude(solution, foundMoves);
+            return true;
+      }
+
+      /**
+       * @brief Outcome of the search; final once run() returned, begin() returned
+       *        false or help() returned true
+       */
+      SolveResult result() {
+            std::lock_guard<std::mutex> lock(idaMutex);
+            return outcome;
+      }
+
+private:
+      static const int MAX_CELLS = 25;
+      static const int FOUND = -1;
+      static const int ABORTED = -2;
+      static const long long POLL_MASK = 1023;
+
+      struct Node {
+            uint8_t cells[MAX_CELLS];  // Tile numbers, blank = cells - 1
+            PackedBoard packed;        // Same board as a table key, kept only when tables is set
+            int blankPos;
+            int cost;
+            int heuristic;
+            int pruneState;
+      };
+
+      // =========================================================================
+      // SETUP AND RESULT
+      // =========================================================================
+
+      SolveResult execute() {
+            if (options.algorithm == SOLVE_IDASTAR) {
+                  int threads = std::max(1, options.threads);
+                  if (begin(threads > 1 ? (size_t)threads * 8 : 1)) {
+                        std::vector<std::thread> helpers;
+                        for (int t = 1; t < threads; t++) {
+                              helpers.push_back(std::thread(&PuzzleSolver::helpUntilDone, this));
+                        }
+                        helpUntilDone();
+                        for (size_t t = 0; t < helpers.size(); t++) helpers[t].join();
+                  }
+                  return outcome;
+            }
+
+            if (!setup()) return outcome;
+            Node root = parse(start);
+            std::string moves;
+            int length;
+            if (options.algorithm == SOLVE_ASTAR) length = aStar(root, moves, outcome.iterations);
+            else length = bfs(root, moves, outcome.iterations);
+            conclude(length, moves);
+            return outcome;
+      }
+
+      /**
+       * @brief Validates the board and the goal and builds the distance tables
+       */
+      bool setup() {
+            if (!prepare(outcome.error)) {
+                  finish(SOLVE_INVALID);
+                  return false;
+            }
+            if (!goalReachable(start, goal, n)) {
+                  finish(SOLVE_UNSOLVABLE);
+                  return false;
+            }
+            return true;
+      }
+
+      /**
+       * @brief Final status from the search's answer (-1: none)
+       */
+      void conclude(int length, const std::string& moves) {
+            if (length >= 0) {
+                  outcome.moves = length;
+                  outcome.path = moves;
+                  if ((int)moves.size() < length) finishFromCache(outcome.path, length);
+                  replay(outcome.path, outcome.boards);
+                  finish(SOLVE_SOLVED);
+            } else if (limitReached) {
+                  finish(SOLVE_NODE_LIMIT);
+            } else if (stopped) {
+                  finish(SOLVE_CANCELLED);
+            } else {
+                  finish(SOLVE_UNSOLVABLE);
+            }
+      }
+
+      void finish(SolveStatus status) {
+            outcome.status = status;
+            outcome.nodesExpanded = nodes.load();
+            outcome.seconds = elapsed();
+      }
+
+      bool prepare(std::string& error) {
+            int size = start.size();
+            n = size == 9 ? 3 : (size == 16 ? 4 : (size == 25 ? 5 : 0));
+            if (n == 0) {
+                  error = "board must have 9, 16 or 25 cells";
+                  return false;
+            }
+            cells = size;
+            successors = &SuccessorTable::square(n);
+
+            std::string target;
+            for (int i = 0; i < cells - 1; i++) target += (char)('A' + i);
+            target += '#';
+            goal = options.goal.empty() ? target : options.goal;
+            if (!sameTiles(start, goal, target)) {
+                  error = "board and goal must use the tiles of " + target;
+                  return false;
+            }
+
+            // Tile t (blank = cells - 1) belongs on goalCell[t]; heuristic 0 means the goal
+            std::vector<int> goalCell = goalCells(goal);
+            for (int tile = 0; tile < cells; tile++) {
+                  int home = goalCell[tile == cells - 1 ? '#' : 'A' + tile];
+                  for (int pos = 0; pos < cells; pos++) {
+                        distance[tile][pos] = std::abs(pos / n - home / n) + std::abs(pos % n - home % n);
+                  }
+            }
+
+            // The host's tables hold packed 4x4 boards and distances to the canonical goal
+            tables = options.table || options.cache || options.pdb;
+            if (tables && (n != 4 || goal != target)) {
+                  error = "transposition table, cache and pattern database need a 4x4 board and the canonical goal";
+                  return false;
+            }
+            exactCache = options.cache;
+            return true;
+      }
+
+      /**
+       * @brief Appends the moves from the cached state that ended moves to the goal
+       *
+       * Every state of a recorded path is cached, so a neighbour one move
+       * closer is normally cached too. If one was evicted, a single IDA*
+       * iteration without the cache, bounded by the known length, finds the rest.
+       */
+      void finishFromCache(std::string& moves, int length) {
+            Node node = parse(start);
+            for (size_t i = 0; i < moves.size(); i++) {
+                  Node next;
+                  child(node, std::string("UDLR").find(moves[i]), next);
+                  node = next;
+            }
+            while (node.heuristic > 0) {
+                  int remaining = length - node.cost;
+                  bool stepped = false;
+                  for (int move = 0; move < 4 && !stepped; move++) {
+                        Node next;
+                        int exact;
+                        if (!child(node, move, next)) continue;
+                        if (next.heuristic == 0 ? remaining == 1
+                                                : exactCache->lookup(next.packed, exact) && exact == remaining - 1) {
+                              moves += SuccessorTable::moveLetter(move);
+                              node = next;
+                              stepped = true;
+                        }
+                  }
+                  if (stepped) continue;
+                  exactCache = nullptr;
+                  std::atomic<bool> done(false);
+                  long long pending = 0;
+                  dfs(node, length, moves, pending, done);
+                  nodes += pending;
+                  return;
+            }
+      }
+
+      void replay(const std::string& moves, std::vector<std::string>& boards) const {
+            std::string board = start;
+            int blank = board.find('#');
+            boards.assign(1, board);
+            for (size_t i = 0; i < moves.size(); i++) {
+                  int next = successors->target(blank, std::string("UDLR").find(moves[i]));
+                  std::swap(board[blank], board[next]);
+                  blank = next;
+                  boards.push_back(board);
+            }
+      }
+
+      // =========================================================================
+      // NODES, HEURISTIC, POLLING
+      // =========================================================================
+
+      int tileDistance(int tile, int pos) const {
+            return distance[tile][pos];
+      }
+
+      Node parse(const std::string& board) const {
+            Node node;
+            node.heuristic = 0;
+            for (int pos = 0; pos < cells; pos++) {
+                  int tile = board[pos] == '#' ? cells - 1 : board[pos] - 'A';
+                  node.cells[pos] = tile;
+                  if (tile == cells - 1) node.blankPos = pos;
+                  else node.heuristic += tileDistance(tile, pos);
+            }
+            node.packed = tables ? packBoard(board) : 0;
+            node.cost = 0;
+            node.pruneState = MOVE_PRUNING_START;
+            return node;
+      }
+
+      std::string key(const Node& node) const {
+            return std::string((const char*)node.cells, cells);
+      }
+
+      /**
+       * @brief Child of node by blank move, or false if the move leaves the board or is pruned
+       */
+      bool child(const Node& node, int move, Node& next) const {
+            int nextState = MOVE_PRUNING_NEXT[node.pruneState][move];
+            if (nextState < 0) return false;
+            int newPos = successors->target(node.blankPos, move);
+            if (newPos < 0) return false;
+            int tile = node.cells[newPos];
+            next = node;
+            next.cells[node.blankPos] = tile;
+            next.cells[newPos] = cells - 1;
+            next.blankPos = newPos;
+            next.cost = node.cost + 1;
+            next.heuristic = node.heuristic + tileDistance(tile, node.blankPos) - tileDistance(tile, newPos);
+            next.pruneState = nextState;
+            if (tables) next.packed = packedMove(node.packed, node.blankPos, newPos);
+            return true;
+      }
+
+      double elapsed() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+      }
+
+      /**
+       * @brief Adds a thread's pending node count; false once the search must stop
+       */
+      bool poll(long long& pending) {
+            long long total = nodes.fetch_add(pending) + pending;
+            pending = 0;
+            if (options.maxNodes > 0 && total >= options.maxNodes) {
+                  limitReached = true;
+                  stopped = true;
+            }
+            if (options.stop && options.stop->stopRequested()) stopped = true;
+            report(false);
+            return !stopped;
+      }
+
+      void setBound(int value) {
+            bound = value;
+            report(true);
+      }
+
+      void report(bool force) {
+            if (!options.progress) return;
+            // Polls skip the report while another thread holds the lock; new bounds wait for it
+            std::unique_lock<std::mutex> lock(progressMutex, std::defer_lock);
+            if (force) lock.lock();
+            else if (!lock.try_lock()) return;
+            double now = elapsed();
+            if (!force && now - lastReport < options.progressInterval) return;
+            lastReport = now;
+            SolveProgress progress = {nodes.load(), bound.load(), now};
+            options.progress(progress);
+      }
+
+      // =========================================================================
+      // IDA*
+      // =========================================================================
+
+      int dfs(Node& node, int threshold, std::string& moves, long long& pending, const std::atomic<bool>& found) {
+            return tables ? dfs<true>(node, threshold, moves, pending, found)
+                          : dfs<false>(node, threshold, moves, pending, found);
+      }
+
+      /**
+       * @brief IDA* below node; WithTables compiles the table lookups in, so
+       *        plain searches keep the lean loop
+       */
+      template <bool WithTables>
+      int dfs(Node& node, int threshold, std::string& moves, long long& pending, const std::atomic<bool>& found) {
+            int heuristic = node.heuristic;
+            if (WithTables) {
+                  // A cached exact distance ends the path; finishFromCache() walks the rest
+                  int exact;
+                  if (exactCache && exactCache->lookup(node.packed, exact)) {
+                        return node.cost + exact > threshold ? node.cost + exact : FOUND;
+                  }
+                  if (options.pdb) heuristic = std::max(heuristic, options.pdb->estimate(node.packed));
+                  int stored;
+                  if (options.table && options.table->probe(node.packed, stored) && stored > heuristic) {
+                        heuristic = stored;
+                  }
+            }
+            int f = node.cost + heuristic;
+            if (f > threshold) return f;
+            if (node.heuristic == 0) return FOUND;
+            if ((++pending & POLL_MASK) == 0 && (!poll(pending) || found.load(std::memory_order_relaxed))) {
+                  return ABORTED;
+            }
+
+            // Moves are made and undone in place: no node copies on the hot path
+            int minimum = INT_MAX;
+            int lowerBound = INT_MAX;  // Over all neighbours, for the transposition table
+            int blank = node.blankPos;
+            int pruneState = node.pruneState;
+            PackedBoard packed = node.packed;
+            for (int k = 0; k < successors->count(blank); k++) {
+                  int move = successors->move(blank, k);
+                  int newPos = successors->neighbor(blank, k);
+                  int nextState = MOVE_PRUNING_NEXT[pruneState][move];
+                  if (nextState < 0) {
+                        // Not searched from here, but the stored bound must hold for every path
+                        if (WithTables && options.table) {
+                              int tile = node.cells[newPos];
+                              int childHeuristic = node.heuristic + tileDistance(tile, blank) - tileDistance(tile, newPos);
+                              lowerBound = std::min(lowerBound, 1 + childHeuristic);
+                        }
+                        continue;
+                  }
+
+                  int tile = node.cells[newPos];
+                  int delta = tileDistance(tile, blank) - tileDistance(tile, newPos);
+                  node.cells[blank] = tile;
+                  node.cells[newPos] = cells - 1;
+                  node.blankPos = newPos;
+                  node.cost++;
+                  node.heuristic += delta;
+                  node.pruneState = nextState;
+                  if (WithTables) node.packed = packedMove(packed, blank, newPos);
+                  moves.push_back(SuccessorTable::moveLetter(move));
+
+                  int result = dfs<WithTables>(node, threshold, moves, pending, found);
+
+                  node.cells[newPos] = tile;
+                  node.cells[blank] = cells - 1;
+                  node.blankPos = blank;
+                  node.cost--;
+                  node.heuristic -= delta;
+                  node.pruneState = pruneState;
+                  if (WithTables) node.packed = packed;
+
+                  if (result == FOUND || result == ABORTED) return result;
+                  moves.erase(moves.size() - 1);
+                  if (result < minimum) minimum = result;
+                  if (WithTables && result != INT_MAX) lowerBound = std::min(lowerBound, result - node.cost);
+            }
+
+            // Every path to the goal through this node costs at least lowerBound
+            if (WithTables && options.table && lowerBound != INT_MAX && lowerBound > heuristic) {
+                  options.table->store(packed, lowerBound, threshold - node.cost);
+            }
+            return minimum;
+      }
+
+      struct Subtree {
+            Node node;
+            std::string moves;
+      };
+
+      /**
+       * @brief Searches subtrees until the IDA* search is complete (run() threads)
+       */
+      void helpUntilDone() {
+            std::unique_lock<std::mutex> lock(idaMutex);
+            while (!idaDone) {
+                  if (nextSubtree < subtrees.size()) {
+                        lock.unlock();
+                        help();
+                        lock.lock();
+                  } else {
+                        idaChanged.wait(lock);
+                  }
+            }
+      }
+
+      // =========================================================================
+      // A* AND BFS (parent moves kept per state for the path)
+      // =========================================================================
+
+      struct OpenEntry {
+            Node node;
+            long long order;
+            int f() const { return node.cost + node.heuristic; }
+            int cost;  // For TieBreakCompare
+      };
+
+      struct Visit {
+            int cost;
+            int8_t move;  // Blank move that reached the state, -1 for the start
+      };
+
+      /**
+       * @brief Walks the parent moves back from the goal
+       */
+      std::string tracePath(const std::unordered_map<std::string, Visit>& visits, Node node) const {
+            static const char names[] = {'U', 'D', 'L', 'R'};
+            static const int inverse[] = {1, 0, 3, 2};
+            std::string moves;
+            while (true) {
+                  int move = visits.find(key(node))->second.move;
+                  if (move < 0) break;
+                  moves += names[move];
+                  int previous = successors->target(node.blankPos, inverse[move]);
+                  std::swap(node.cells[node.blankPos], node.cells[previous]);
+                  node.blankPos = previous;
+            }
+            std::reverse(moves.begin(), moves.end());
+            return moves;
+      }
+
+      int aStar(const Node& root, std::string& moves, int& iterations) {
+            std::priority_queue<OpenEntry, std::vector<OpenEntry>, TieBreakCompare<OpenEntry> > open(
+                  (TieBreakCompare<OpenEntry>(TIE_HIGH_G)));
+            std::unordered_map<std::string, Visit> visits;
+            long long generated = 0, pending = 0;
+            iterations = 1;
+
+            OpenEntry first = {root, generated++, root.cost};
+            open.push(first);
+            Visit visit = {0, -1};
+            visits[key(root)] = visit;
+            setBound(root.heuristic);
+
+            while (!open.empty()) {
+                  OpenEntry current = open.top();
+                  open.pop();
+                  if (current.node.heuristic == 0) {
+                        nodes += pending;
+                        moves = tracePath(visits, current.node);
+                        return current.node.cost;
+                  }
+                  if (current.node.cost > visits[key(current.node)].cost) continue;  // stale entry
+                  if (current.f() > bound) setBound(current.f());
+                  if ((++pending & POLL_MASK) == 0 && !poll(pending)) return -1;
+
+                  for (int move = 0; move < 4; move++) {
+                        OpenEntry next;
+                        if (!child(current.node, move, next.node)) continue;
+                        std::string k = key(next.node);
+                        std::unordered_map<std::string, Visit>::iterator seen = visits.find(k);
+                        if (seen != visits.end() && seen->second.cost <= next.node.cost) continue;
+                        Visit entry = {next.node.cost, (int8_t)move};
+                        visits[k] = entry;
+                        next.order = generated++;
+                        next.cost = next.node.cost;
+                        open.push(next);
+                  }
+            }
+            nodes += pending;
+            return -1;
+      }
+
+      int bfs(const Node& root, std::string& moves, int& iterations) {
+            std::unordered_map<std::string, Visit> visits;
+            std::vector<Node> frontier(1, root), next;
+            long long pending = 0;
+            iterations = 1;
+            Visit visit = {0, -1};
+            visits[key(root)] = visit;
+
+            for (int depth = 0; !frontier.empty(); depth++) {
+                  setBound(depth);
+                  next.clear();
+                  for (size_t i = 0; i < frontier.size(); i++) {
+                        if (frontier[i].heuristic == 0) {
+                              nodes += pending;
+                              moves = tracePath(visits, frontier[i]);
+                              return depth;
+                        }
+                        if ((++pending & POLL_MASK) == 0 && !poll(pending)) return -1;
+                        for (int move = 0; move < 4; move++) {
+                              Node successor;
+                              if (!child(frontier[i], move, successor)) continue;
+                              Visit entry = {depth + 1, (int8_t)move};
+                              if (visits.insert(std::make_pair(key(successor), entry)).second) {
+                                    next.push_back(successor);
+                              }
+                        }
+                  }
+                  frontier.swap(next);
+            }
+            nodes += pending;
+            return -1;
+      }
+
+      SolveOptions options;
+      std::string start;
+      std::string goal;                  // options.goal, or the canonical goal
+      int n;
+      int cells;
+      const SuccessorTable* successors;  // Blank moves of the n x n board
+      bool tables;                       // The options lend a table, cache or pattern database
+      SolvedStateCache* exactCache;      // options.cache, dropped by finishFromCache's fallback
+      uint8_t distance[MAX_CELLS][MAX_CELLS];  // Manhattan distance of tile from cell
+      std::atomic<long long> nodes;
+      std::atomic<int> bound;
+      std::atomic<bool> stopped;
+      std::atomic<bool> limitReached;
+      std::chrono::steady_clock::time_point startTime;
+      double lastReport;              // Guarded by progressMutex
+      std::mutex progressMutex;
+
+      // IDA* iterations, guarded by idaMutex (subtrees is fixed after begin())
+      std::vector<Subtree> subtrees;
+      size_t nextSubtree;             // Next unclaimed subtree of the iteration
+      size_t running;                 // Subtrees being searched
+      size_t finishedSubtrees;        // Subtrees done in the iteration
+      int threshold;
+      int iterationMinimum;
+      int solution;
+      std::string foundMoves;
+      bool idaDone;
+      std::atomic<bool> found;        // Read by dfs without the lock
+      std::mutex idaMutex;
+      std::condition_variable idaChanged;
+      SolveResult outcome;
+};
+
+#endif // PUZZLE_SOLVER_H
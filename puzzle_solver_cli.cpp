@@ -0,0 +1,106 @@
+/**
+ * @file puzzle_solver_cli.cpp
+ * @brief Thin command-line wrapper around the embeddable solver (puzzle_solver.h)
+ *
+ * Reads "BOARD [GOAL]" from cin, starts PuzzleSolver::solve() and waits on the
+ * returned future. With --timeout the wait is bounded: when it expires the
+ * wrapper raises the stop token and collects the cancelled result, which is
+ * how a host program would cancel a solve. The last line of output is the
+ * solution length (-1 when there is none), as in the other solvers.
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -pthread -o puzzle_solver_cli puzzle_solver_cli.cpp
+ *
+ * Usage:
+ *   echo BOARD [GOAL] | puzzle_solver_cli [--algorithm A] [--threads T] [--max-nodes N]
+ *                                         [--timeout S] [--progress] [--path] [--stats]
+ *
+ *   --algorithm A   idastar (default), astar or bfs
+ *   --threads T     IDA* threads (default 1)
+ *   --max-nodes N   Stop after N expansions (default: no limit)
+ *   --timeout S     Cancel the solve after S seconds
+ *   --progress      Print nodes, bound and elapsed time on stderr while searching
+ *   --path          Print the blank moves and the boards before the length
+ *   --stats         Print status, nodes, iterations and time on stderr
+ *
+ * Example:
+ *   echo EABCM#GDKFILNOJH | puzzle_solver_cli --threads 4 --path --progress
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include "puzzle_solver.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+      SolveOptions options;
+      double timeout = 0;
+      bool showPath = false;
+      bool showStats = false;
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--algorithm") == 0 && i + 1 < argc) {
+                  if (!parseSolveAlgorithm(argv[++i], options.algorithm)) {
+                        cerr << "Error: unknown algorithm " << argv[i] << endl;
+                        return 1;
+                  }
+            } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                  options.threads = max(1, atoi(argv[++i]));
+            } else if (strcmp(argv[i], "--max-nodes") == 0 && i + 1 < argc) {
+                  options.maxNodes = atoll(argv[++i]);
+            } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+                  timeout = atof(argv[++i]);
+            } else if (strcmp(argv[i], "--progress") == 0) {
+                  options.progress = [](const SolveProgress& p) {
+                        cerr << fixed << setprecision(2) << "[" << p.seconds << " s] bound " << p.bound
+                             << ", " << p.nodes << " nodes" << endl;
+                  };
+            } else if (strcmp(argv[i], "--path") == 0) {
+                  showPath = true;
+            } else if (strcmp(argv[i], "--stats") == 0) {
+                  showStats = true;
+            } else {
+                  cerr << "Usage: " << argv[0] << " [--algorithm idastar|astar|bfs] [--threads T] [--max-nodes N]"
+                       << " [--timeout S] [--progress] [--path] [--stats]" << endl;
+                  return 1;
+            }
+      }
+
+      string start;
+      if (!(cin >> start)) {
+            cerr << "Error: expected a board such as ABCDEFGHIJKLMNO#" << endl;
+            return 1;
+      }
+      cin >> options.goal;
+      options.stop = make_shared<StopToken>();
+
+      future<SolveResult> pending = PuzzleSolver::solve(start, options);
+      if (timeout > 0 &&
+          pending.wait_for(chrono::duration<double>(timeout)) == future_status::timeout) {
+            options.stop->requestStop();
+      }
+      SolveResult result = pending.get();
+
+      if (result.status == SOLVE_INVALID) {
+            cerr << "Error: " << result.error << endl;
+            return 1;
+      }
+      if (showStats) {
+            cerr << "Status: " << solveStatusName(result.status) << ", " << solveAlgorithmName(options.algorithm)
+                 << ", " << result.nodesExpanded << " nodes, " << result.iterations << " iterations, "
+                 << fixed << setprecision(3) << result.seconds << " s" << endl;
+      }
+      if (showPath && result.status == SOLVE_SOLVED) {
+            cout << (result.path.empty() ? "-" : result.path) << endl;
+            for (size_t i = 0; i < result.boards.size(); i++) cout << result.boards[i] << endl;
+      }
+      cout << result.moves << endl;
+      return 0;
+}
@@ -0,0 +1,475 @@
+/**
+ * @file puzzle_solver_daemon.cpp
+ * @brief Resident 15-puzzle solver server with warm tables
+ *
+ * Long-lived server that answers solve requests over a Unix domain socket (or
+ * a pipe on stdin/stdout). The worker threads, the row pattern database
+ * (symmetry_heuristic.h) and the transposition table are built once at
+ * startup, so an easy puzzle costs only its search instead of process startup
+ * plus setup. Each request is an IDA* search of the embeddable solver
+ * (puzzle_solver.h) on one worker thread, with those tables lent through
+ * SolveOptions. Lower bounds stored in the transposition table stay valid
+ * across requests (the goal never changes), so later requests also start
+ * with warmer bounds. With --cache, exact distances of every state on each
+ * optimal path are kept in a persistent solved-state cache: repeated puzzles
+ * are answered in microseconds and related ones stop as soon as their search
+ * reaches a cached state.
+ *
+ * Line protocol (one request per line, one response per line):
+ *   SOLVE <board> [goal]  ->  OK <board> <moves> <latency_us>  |  ERR <board> <reason>
+ *   STATS           ->  STATS count=<n> p50_us=<..> p90_us=<..> p99_us=<..> max_us=<..>
+ *   PING            ->  PONG
+ *   QUIT            ->  BYE   (closes this connection)
+ *   SHUTDOWN        ->  BYE   (stops the server)
+ *
+ * One I/O thread reads every connection (poll() on the socket, a blocking
+ * read on the pipe) and answers PING, STATS, QUIT and SHUTDOWN itself; only
+ * SOLVE requests go to the worker pool, so idle connections hold no worker
+ * and the requests of one connection are solved concurrently. Responses echo
+ * the board because they may complete out of order. QUIT closes the
+ * connection once its pending SOLVE requests are answered. SHUTDOWN raises a
+ * StopToken shared by every search, so running requests end with
+ * "ERR <board> cancelled" instead of delaying the exit. Custom goals with
+ * the blank in a corner are relabelled onto TARGET (goal_relabel.h), so the
+ * tables and cache are shared by all of them; other goals are searched as
+ * given with Manhattan distance only.
+ *
+ * Compilation:
+ *   g++ -std=c++11 -O2 -pthread -o puzzle_solver_daemon puzzle_solver_daemon.cpp
+ *
+ * Usage:
+ *   puzzle_solver_daemon --socket /tmp/puzzle.sock [--threads N] [--tt-mb MB] [--cache FILE]
+ *                        [--heuristic manhattan|pdb]
+ *   puzzle_solver_daemon --stdio [--threads N] [--tt-mb MB] [--cache FILE] [--heuristic manhattan|pdb]
+ *
+ *   --tt-mb MB   Transposition table memory budget (default 256, 0 disables it)
+ *   --heuristic  pdb (default): max of Manhattan and the row pattern database
+ *                with reflected and dual lookups; manhattan skips the database
+ *
+ * Example:
+ *   printf 'SOLVE EC#DBAJHIGFLMNKO\nSTATS\n' | socat - UNIX-CONNECT:/tmp/puzzle.sock
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "packed_board.h"
+#include "transposition_table.h"
+#include "solved_state_cache.h"
+#include "symmetry_heuristic.h"
+#include "goal_relabel.h"
+#include "puzzle_solver.h"
+
+using namespace std;
+using namespace chrono;
+
+const string TARGET = "ABCDEFGHIJKLMNO#";
+
+// Warm tables (built once per process), shared by every request on the canonical goal
+TranspositionTable* table = nullptr;
+SolvedStateCache* cache = nullptr;
+const SymmetricPatternDatabase* pdb = nullptr;
+
+// Raised by SHUTDOWN; every search polls it
+shared_ptr<StopToken> shutdownToken = make_shared<StopToken>();
+
+// =============================================================================
+// LATENCY STATISTICS
+// =============================================================================
+
+mutex statsMutex;
+vector<long long> latencies;  // microseconds, one per SOLVE request
+
+void recordLatency(long long micros) {
+      lock_guard<mutex> lock(statsMutex);
+      latencies.push_back(micros);
+}
+
+string formatStats() {
+      vector<long long> sorted;
+      {
+            lock_guard<mutex> lock(statsMutex);
+            sorted = latencies;
+      }
+      sort(sorted.begin(), sorted.end());
+
+      auto percentile = [&](double p) -> long long {
+            if (sorted.empty()) return 0;
+            size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+            return sorted[idx];
+      };
+
+      ostringstream out;
+      out << "STATS count=" << sorted.size()
+          << " p50_us=" << percentile(0.50)
+          << " p90_us=" << percentile(0.90)
+          << " p99_us=" << percentile(0.99)
+          << " max_us=" << (sorted.empty() ? 0 : sorted.back());
+      return out.str();
+}
+
+// =============================================================================
+// REQUEST HANDLING
+// =============================================================================
+
+string handleSolve(const string& board, const string& goal) {
+      auto startTime = high_resolution_clock::now();
+
+      // Corner goals run on the canonical goal, so the tables serve all of them
+      string canonical = board;
+      SolveOptions options;
+      options.stop = shutdownToken;
+      if (!goal.empty() && !sameTiles(board, goal, TARGET)) {
+            return "ERR " + board + " invalid-goal";
+      }
+      if (!goal.empty() && goalBlankInCorner(goal, 4)) {
+            relabelToCanonical(board, goal, TARGET, 4, canonical);
+      } else if (!goal.empty()) {
+            options.goal = goal;
+      }
+      if (options.goal.empty()) {
+            options.table = table;
+            options.cache = cache;
+            options.pdb = pdb;
+      }
+      string error;
+      if (canonical.length() != TARGET.length() || !PuzzleSolver::accepts(canonical, options, error)) {
+            return "ERR " + board + (error == "unsolvable" ? " unsolvable" : " invalid-board");
+      }
+
+      int solution;
+      if (!options.cache || !cache->lookup(packBoard(canonical), solution)) {
+            SolveResult result = PuzzleSolver::run(canonical, options);
+            if (result.status == SOLVE_CANCELLED) return "ERR " + board + " cancelled";
+            solution = result.moves;
+            if (options.cache && result.status == SOLVE_SOLVED) {
+                  vector<PackedBoard> path;
+                  for (size_t i = 0; i < result.boards.size(); i++) path.push_back(packBoard(result.boards[i]));
+                  cache->recordPath(path);
+            }
+      }
+      long long micros = duration_cast<microseconds>(high_resolution_clock::now() - startTime).count();
+      recordLatency(micros);
+
+      ostringstream out;
+      out << "OK " << board << " " << solution << " " << micros;
+      return out.str();
+}
+
+/**
+ * @brief Answers one non-SOLVE command
+ * @return false if the connection must be closed after the response
+ */
+bool handleCommand(const string& command, string& response) {
+      if (command == "STATS") {
+            response = formatStats();
+      } else if (command == "PING") {
+            response = "PONG";
+      } else if (command == "QUIT") {
+            response = "BYE";
+            return false;
+      } else if (command == "SHUTDOWN") {
+            response = "BYE";
+            shutdownToken->requestStop();
+            return false;
+      } else {
+            response = "ERR unknown-command";
+      }
+      return true;
+}
+
+// =============================================================================
+// THREAD POOL
+// =============================================================================
+
+class ThreadPool {
+public:
+      explicit ThreadPool(int numThreads) : stopping(false) {
+            for (int i = 0; i < numThreads; i++) {
+                  workers.push_back(thread([this]() { workerLoop(); }));
+            }
+      }
+
+      ~ThreadPool() {
+            {
+                  lock_guard<mutex> lock(queueMutex);
+                  stopping = true;
+            }
+            queueReady.notify_all();
+            for (thread& t : workers) t.join();
+      }
+
+      void submit(function<void()> task) {
+            {
+                  lock_guard<mutex> lock(queueMutex);
+                  tasks.push(task);
+            }
+            queueReady.notify_one();
+      }
+
+private:
+      void workerLoop() {
+            while (true) {
+                  function<void()> task;
+                  {
+                        unique_lock<mutex> lock(queueMutex);
+                        queueReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = tasks.front();
+                        tasks.pop();
+                  }
+                  task();
+            }
+      }
+
+      vector<thread> workers;
+      queue<function<void()>> tasks;
+      mutex queueMutex;
+      condition_variable queueReady;
+      bool stopping;
+};
+
+// =============================================================================
+// TRANSPORTS
+// =============================================================================
+
+bool sendLine(int fd, const string& line) {
+      string data = line + "\n";
+      size_t sent = 0;
+      while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += n;
+      }
+      return true;
+}
+
+/**
+ * @brief A client socket, shared by the I/O thread and its pending SOLVE jobs
+ *
+ * The descriptor is closed when the last owner lets go, so a job never
+ * answers on a descriptor that was closed and reused by a new client.
+ */
+struct Connection {
+      int fd;
+      string buffer;     // Bytes received after the last complete line
+      bool quitting;     // QUIT received: no further requests are read
+      mutex sendMutex;
+
+      explicit Connection(int socketFd) : fd(socketFd), quitting(false) {}
+      ~Connection() { close(fd); }
+
+      void reply(const string& line) {
+            lock_guard<mutex> lock(sendMutex);
+            sendLine(fd, line);
+      }
+};
+
+/**
+ * @brief Handles the complete lines in the connection buffer
+ */
+void processLines(const shared_ptr<Connection>& connection, ThreadPool& pool) {
+      size_t newline;
+      while (!connection->quitting && (newline = connection->buffer.find('\n')) != string::npos) {
+            string line = connection->buffer.substr(0, newline);
+            connection->buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+
+            istringstream in(line);
+            string command, board, goal;
+            in >> command;
+            if (command.empty()) continue;
+
+            if (command == "SOLVE") {
+                  in >> board >> goal;
+                  pool.submit([connection, board, goal]() {
+                        connection->reply(handleSolve(board, goal));
+                  });
+            } else {
+                  string response;
+                  if (!handleCommand(command, response)) connection->quitting = true;
+                  connection->reply(response);
+            }
+      }
+}
+
+int runSocketServer(const string& path, ThreadPool& pool) {
+      int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (listenFd < 0) {
+            cerr << "Error: cannot create socket" << endl;
+            return 1;
+      }
+
+      sockaddr_un addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sun_family = AF_UNIX;
+      if (path.length() >= sizeof(addr.sun_path)) {
+            cerr << "Error: socket path too long" << endl;
+            return 1;
+      }
+      strcpy(addr.sun_path, path.c_str());
+      unlink(path.c_str());
+
+      if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 64) < 0) {
+            cerr << "Error: cannot listen on " << path << endl;
+            close(listenFd);
+            return 1;
+      }
+      cerr << "Listening on " << path << endl;
+
+      // I/O thread: this loop reads every connection; workers only solve
+      map<int, shared_ptr<Connection> > connections;
+      vector<pollfd> fds;
+      char chunk[4096];
+
+      while (!shutdownToken->stopRequested()) {
+            fds.clear();
+            pollfd listener = {listenFd, POLLIN, 0};
+            fds.push_back(listener);
+            for (auto& entry : connections) {
+                  pollfd client = {entry.first, POLLIN, 0};
+                  fds.push_back(client);
+            }
+            if (poll(fds.data(), fds.size(), -1) < 0) continue;
+
+            for (size_t i = 1; i < fds.size(); i++) {
+                  if (fds[i].revents == 0) continue;
+                  shared_ptr<Connection> connection = connections[fds[i].fd];
+                  ssize_t n = recv(connection->fd, chunk, sizeof(chunk), 0);
+                  if (n > 0) {
+                        connection->buffer.append(chunk, n);
+                        processLines(connection, pool);
+                  }
+                  // Pending jobs keep the descriptor open until they have answered
+                  if (n <= 0 || connection->quitting) connections.erase(connection->fd);
+                  if (shutdownToken->stopRequested()) break;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                  int clientFd = accept(listenFd, nullptr, nullptr);
+                  if (clientFd >= 0) connections[clientFd] = make_shared<Connection>(clientFd);
+            }
+      }
+
+      connections.clear();
+      close(listenFd);
+      unlink(path.c_str());
+      return 0;
+}
+
+/**
+ * @brief Pipe mode: requests on stdin, responses on stdout
+ *
+ * SOLVE requests are dispatched to the pool and answered as they finish.
+ */
+int runStdioServer(ThreadPool& pool) {
+      mutex outputMutex;
+      atomic<int> pending(0);
+      string line;
+
+      while (!shutdownToken->stopRequested() && getline(cin, line)) {
+            istringstream in(line);
+            string command, board, goal;
+            in >> command;
+            if (command.empty()) continue;
+
+            if (command == "SOLVE") {
+                  in >> board >> goal;
+                  pending++;
+                  pool.submit([board, goal, &outputMutex, &pending]() {
+                        string response = handleSolve(board, goal);
+                        {
+                              lock_guard<mutex> lock(outputMutex);
+                              cout << response << endl;
+                        }
+                        pending--;
+                  });
+            } else {
+                  string response;
+                  bool open = handleCommand(command, response);
+                  {
+                        lock_guard<mutex> lock(outputMutex);
+                        cout << response << endl;
+                  }
+                  if (!open) break;
+            }
+      }
+
+      while (pending > 0) this_thread::sleep_for(milliseconds(1));
+      return 0;
+}
+
+// =============================================================================
+// MAIN FUNCTION
+// =============================================================================
+
+int main(int argc, char* argv[]) {
+      string socketPath;
+      bool stdioMode = false;
+      int numThreads = thread::hardware_concurrency();
+      size_t tableMB = 256;
+      string cachePath;
+      string heuristic = "pdb";
+
+      for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+                  socketPath = argv[++i];
+            } else if (strcmp(argv[i], "--stdio") == 0) {
+                  stdioMode = true;
+            } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                  numThreads = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--tt-mb") == 0 && i + 1 < argc) {
+                  tableMB = atol(argv[++i]);
+            } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                  cachePath = argv[++i];
+            } else if (strcmp(argv[i], "--heuristic") == 0 && i + 1 < argc) {
+                  heuristic = argv[++i];
+            }
+      }
+
+      if (socketPath.empty() && !stdioMode) {
+            cerr << "Usage: " << argv[0] << " --socket <path> | --stdio [--threads N] [--tt-mb MB] [--cache FILE]"
+                 << " [--heuristic manhattan|pdb]" << endl;
+            return 1;
+      }
+      if (heuristic != "manhattan" && heuristic != "pdb") {
+            cerr << "Error: unknown heuristic " << heuristic << " (use manhattan or pdb)" << endl;
+            return 1;
+      }
+      if (numThreads < 1) numThreads = 1;
+
+      if (tableMB > 0) table = new TranspositionTable(tableMB * 1024 * 1024);
+      if (!cachePath.empty()) cache = new SolvedStateCache(cachePath, 1 << 22);
+      if (heuristic == "pdb") pdb = new SymmetricPatternDatabase();
+
+      int status;
+      {
+            ThreadPool pool(numThreads);
+            status = stdioMode ? runStdioServer(pool) : runSocketServer(socketPath, pool);
+      }
+
+      delete pdb;
+      delete cache;
+      delete table;
+      return status;
+}
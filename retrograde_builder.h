@@ -0,0 +1,271 @@
+/**
+ * @file retrograde_builder.h
+ * @brief Parallel level-synchronous backward BFS filling a dense distance table
+ *
+ * Distance tables (the whole 3x3 space, pattern databases) are a BFS from the
+ * goal over a state space whose states can be ranked densely. Instead of the
+ * visited hash set and frontier lists of parallelBFS, the table itself is the
+ * search state: one byte per rank, UNSEEN until the state is reached. Level d
+ * is expanded by scanning the table in parallel for entries equal to d; every
+ * new neighbour is claimed with an atomic compare-and-swap UNSEEN -> d + 1,
+ * so each state is counted exactly once without locks.
+ *
+ * The caller describes the space with a class providing:
+ *   typedef ... State;
+ *   uint64_t size() const;                                    // number of ranks
+ *   uint64_t rank(const State& s) const;
+ *   State unrank(uint64_t rank) const;
+ *   void neighbors(const State& s, std::vector<State>& out) const;
+ *
+ * Moves must be reversible (true for sliding puzzles), so forward neighbours
+ * are also predecessors. Ranks that are never reached stay UNSEEN.
+ *
+ * After every level the builder reports progress and, if a checkpoint file
+ * was set, writes the table there (through a temporary file and rename); a
+ * later build with the same file resumes from the last completed level.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef RETROGRADE_BUILDER_H
+#define RETROGRADE_BUILDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+/**
+ * @brief Statistics of one completed level
+ */
+struct RetrogradeProgress {
+      int level;              // Distance of the states just found
+      uint64_t newStates;     // States at that distance
+      uint64_t totalStates;   // States found so far
+      uint64_t scannedRanks;  // Table entries scanned to expand the previous level
+      double levelSeconds;
+      double totalSeconds;
+      bool resumed;           // Level restored from the checkpoint
+};
+
+template <class Space>
+class RetrogradeBuilder {
+public:
+      typedef typename Space::State State;
+      static const uint8_t UNSEEN = 255;
+      static const int MAX_LEVEL = 254;
+
+      RetrogradeBuilder(const Space& s, int threads)
+            : space(s), numThreads(threads), entries(s.size()), table(new std::atomic<uint8_t>[s.size()]),
+              levels(0), reached(0) {}
+
+      /**
+       * @brief Writes the table to this file after every level and resumes from it
+       */
+      void setCheckpoint(const std::string& path) { checkpointPath = path; }
+
+      void setProgressCallback(std::function<void(const RetrogradeProgress&)> callback) {
+            progress = callback;
+      }
+
+      /**
+       * @brief Fills the table with the distance of every rank to the nearest goal
+       * @return false if a checkpoint could not be written or depths exceed MAX_LEVEL
+       */
+      bool build(const std::vector<State>& goals) {
+            auto start = std::chrono::steady_clock::now();
+            int level = 0;
+            if (!checkpointPath.empty() && loadCheckpoint(level)) {
+                  reportResumed(level);
+            } else {
+                  for (uint64_t r = 0; r < entries; r++) table[r].store(UNSEEN, std::memory_order_relaxed);
+                  reached = 0;
+                  for (size_t i = 0; i < goals.size(); i++) {
+                        uint8_t expected = UNSEEN;
+                        if (table[space.rank(goals[i])].compare_exchange_strong(expected, 0)) reached++;
+                  }
+                  levelCounts.assign(1, reached);
+                  report(0, reached, 0.0, start, false);
+                  if (!saveCheckpoint(0)) return false;
+            }
+
+            while (true) {
+                  if (level >= MAX_LEVEL) return false;
+                  auto levelStart = std::chrono::steady_clock::now();
+                  uint64_t added = expandLevel(level);
+                  if (added == 0) break;
+
+                  level++;
+                  reached += added;
+                  levelCounts.push_back(added);
+                  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - levelStart).count();
+                  report(level, added, seconds, start, false);
+                  if (!saveCheckpoint(level)) return false;
+            }
+            levels = level;
+            return true;
+      }
+
+      uint8_t distance(uint64_t rank) const { return table[rank].load(std::memory_order_relaxed); }
+
+      uint64_t size() const { return entries; }
+
+      uint64_t reachedStates() const { return reached; }
+
+      /**
+       * @brief Largest distance in the table
+       */
+      int maxLevel() const { return levels; }
+
+      /**
+       * @brief States found at each distance
+       */
+      const std::vector<uint64_t>& histogram() const { return levelCounts; }
+
+      /**
+       * @brief Writes one byte per rank (UNSEEN for unreachable ranks)
+       */
+      bool save(const std::string& path) const {
+            FILE* file = fopen(path.c_str(), "wb");
+            if (!file) return false;
+            bool ok = writeTable(file);
+            return fclose(file) == 0 && ok;
+      }
+
+private:
+      static const uint64_t CHECKPOINT_MAGIC = 0x3130304F52544552ULL;  // "RETRO001"
+
+      uint64_t expandLevel(int level) {
+            uint64_t added = 0;
+            const uint8_t current = (uint8_t)level;
+            const uint8_t next = (uint8_t)(level + 1);
+
+            #pragma omp parallel num_threads(numThreads) reduction(+:added)
+            {
+                  std::vector<State> neighbors;
+                  #pragma omp for schedule(dynamic, 4096)
+                  for (long long r = 0; r < (long long)entries; r++) {
+                        if (table[r].load(std::memory_order_relaxed) != current) continue;
+                        neighbors.clear();
+                        space.neighbors(space.unrank(r), neighbors);
+                        for (size_t i = 0; i < neighbors.size(); i++) {
+                              uint64_t n = space.rank(neighbors[i]);
+                              if (table[n].load(std::memory_order_relaxed) != UNSEEN) continue;
+                              uint8_t expected = UNSEEN;
+                              if (table[n].compare_exchange_strong(expected, next, std::memory_order_relaxed)) {
+                                    added++;
+                              }
+                        }
+                  }
+            }
+            return added;
+      }
+
+      void report(int level, uint64_t added, double seconds,
+                  std::chrono::steady_clock::time_point start, bool resumed) const {
+            if (!progress) return;
+            RetrogradeProgress info;
+            info.level = level;
+            info.newStates = added;
+            info.totalStates = reached;
+            info.scannedRanks = level > 0 ? entries : 0;
+            info.levelSeconds = seconds;
+            info.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            info.resumed = resumed;
+            progress(info);
+      }
+
+      void reportResumed(int level) const {
+            if (!progress) return;
+            uint64_t total = 0;
+            for (int l = 0; l <= level; l++) {
+                  RetrogradeProgress info;
+                  total += levelCounts[l];
+                  info.level = l;
+                  info.newStates = levelCounts[l];
+                  info.totalStates = total;
+                  info.scannedRanks = 0;
+                  info.levelSeconds = info.totalSeconds = 0;
+                  info.resumed = true;
+                  progress(info);
+            }
+      }
+
+      bool writeTable(FILE* file) const {
+            std::vector<uint8_t> buffer(1 << 20);
+            for (uint64_t r = 0; r < entries; r += buffer.size()) {
+                  size_t count = std::min<uint64_t>(buffer.size(), entries - r);
+                  for (size_t i = 0; i < count; i++) buffer[i] = table[r + i].load(std::memory_order_relaxed);
+                  if (fwrite(buffer.data(), 1, count, file) != count) return false;
+            }
+            return true;
+      }
+
+      // Header: magic, entries, completed level, level counts; then the table
+      bool saveCheckpoint(int level) const {
+            if (checkpointPath.empty()) return true;
+            std::string temporary = checkpointPath + ".tmp";
+            FILE* file = fopen(temporary.c_str(), "wb");
+            if (!file) {
+                  fprintf(stderr, "Error: cannot write checkpoint %s\n", temporary.c_str());
+                  return false;
+            }
+            uint64_t header[3] = {CHECKPOINT_MAGIC, entries, (uint64_t)level};
+            bool ok = fwrite(header, sizeof(header), 1, file) == 1
+                   && fwrite(levelCounts.data(), sizeof(uint64_t), level + 1, file) == (size_t)level + 1
+                   && writeTable(file);
+            ok = fclose(file) == 0 && ok;
+            if (!ok || rename(temporary.c_str(), checkpointPath.c_str()) != 0) {
+                  fprintf(stderr, "Error: cannot write checkpoint %s\n", checkpointPath.c_str());
+                  return false;
+            }
+            return true;
+      }
+
+      bool loadCheckpoint(int& level) {
+            FILE* file = fopen(checkpointPath.c_str(), "rb");
+            if (!file) return false;
+            uint64_t header[3];
+            bool ok = fread(header, sizeof(header), 1, file) == 1
+                   && header[0] == CHECKPOINT_MAGIC && header[1] == entries && header[2] <= MAX_LEVEL;
+            if (ok) {
+                  levelCounts.resize(header[2] + 1);
+                  ok = fread(levelCounts.data(), sizeof(uint64_t), levelCounts.size(), file) == levelCounts.size();
+            }
+            std::vector<uint8_t> buffer(1 << 20);
+            for (uint64_t r = 0; ok && r < entries; r += buffer.size()) {
+                  size_t count = std::min<uint64_t>(buffer.size(), entries - r);
+                  ok = fread(buffer.data(), 1, count, file) == count;
+                  for (size_t i = 0; ok && i < count; i++) table[r + i].store(buffer[i], std::memory_order_relaxed);
+            }
+            fclose(file);
+            if (!ok) {
+                  fprintf(stderr, "Warning: ignoring invalid checkpoint %s\n", checkpointPath.c_str());
+                  return false;
+            }
+            level = header[2];
+            reached = 0;
+            for (size_t l = 0; l < levelCounts.size(); l++) reached += levelCounts[l];
+            return true;
+      }
+
+      const Space& space;
+      int numThreads;
+      uint64_t entries;
+      std::unique_ptr<std::atomic<uint8_t>[]> table;
+      std::vector<uint64_t> levelCounts;
+      int levels;
+      uint64_t reached;
+      std::string checkpointPath;
+      std::function<void(const RetrogradeProgress&)> progress;
+};
+
+#endif // RETROGRADE_BUILDER_H
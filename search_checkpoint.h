@@ -0,0 +1,356 @@
+/**
+ * @file search_checkpoint.h
+ * @brief Binary search snapshots written on a background thread
+ *
+ * Long BFS and A* runs save their state at layer boundaries (BFS level,
+ * A* f value) so that a crash or preemption only loses the work since the
+ * last snapshot. A snapshot is a list of named sections, each a flat array of
+ * fixed-size elements (packed boards, costs, ...), plus the engine name, the
+ * start board and a few counters:
+ *
+ *   magic, engine, start, counters, sections (name, element size, count,
+ *   raw elements), FNV-1a checksum of everything before it
+ *
+ * The search thread only fills the section arrays; CheckpointWriter takes
+ * them by swap and a background thread writes the file (through a temporary
+ * file and rename, as retrograde_builder.h does), so the search continues
+ * while the disk is busy. A new snapshot is taken only when the interval has
+ * passed, the previous write has finished and the search has run for at
+ * least 1 / CHECKPOINT_COPY_BUDGET times as long as the last copy took: the
+ * tables grow with the search, and without that rule a fixed interval would
+ * let the copies of a long run dominate it.
+ *
+ * loadSnapshot() rejects files with a bad magic or checksum, so a snapshot
+ * interrupted half-way is never resumed from.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef SEARCH_CHECKPOINT_H
+#define SEARCH_CHECKPOINT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const uint64_t SNAPSHOT_MAGIC = 0x3130504b43535a50ULL;  // "PZSCKP01"
+const double CHECKPOINT_COPY_BUDGET = 0.02;             // Share of the search spent copying
+
+struct SnapshotSection {
+      std::string name;
+      uint32_t elementSize;
+      std::vector<char> data;
+};
+
+struct SearchSnapshot {
+      std::string engine;             // Which solver wrote it
+      std::string start;              // Board being solved (and the goal, when not the canonical one)
+      std::vector<int64_t> counters;  // Engine-defined: depth, nodes, ...
+      std::vector<SnapshotSection> sections;
+
+      void clear() {
+            counters.clear();
+            sections.clear();
+      }
+
+      /**
+       * @brief Appends a section holding a copy of values
+       */
+      template <class T>
+      void put(const std::string& name, const std::vector<T>& values) {
+            sections.push_back(SnapshotSection());
+            SnapshotSection& section = sections.back();
+            section.name = name;
+            section.elementSize = sizeof(T);
+            section.data.resize(values.size() * sizeof(T));
+            if (!values.empty()) memcpy(&section.data[0], &values[0], section.data.size());
+      }
+
+      /**
+       * @brief Copies the named section into values; false if missing or of another type
+       */
+      template <class T>
+      bool get(const std::string& name, std::vector<T>& values) const {
+            for (size_t s = 0; s < sections.size(); s++) {
+                  if (sections[s].name != name) continue;
+                  if (sections[s].elementSize != sizeof(T)) return false;
+                  values.resize(sections[s].data.size() / sizeof(T));
+                  if (!values.empty()) memcpy(&values[0], &sections[s].data[0], values.size() * sizeof(T));
+                  return true;
+            }
+            return false;
+      }
+
+      size_t bytes() const {
+            size_t total = 0;
+            for (size_t s = 0; s < sections.size(); s++) total += sections[s].data.size();
+            return total;
+      }
+};
+
+// =============================================================================
+// FILE FORMAT
+// =============================================================================
+
+/**
+ * @brief fwrite wrapper that also folds the bytes into an FNV-1a checksum
+ */
+class ChecksumFile {
+public:
+      explicit ChecksumFile(FILE* f) : file(f), hash(0xcbf29ce484222325ULL), ok(true) {}
+
+      void write(const void* data, size_t bytes) {
+            fold(data, bytes);
+            ok = ok && fwrite(data, 1, bytes, file) == bytes;
+      }
+
+      void read(void* data, size_t bytes) {
+            ok = ok && fread(data, 1, bytes, file) == bytes;
+            if (ok) fold(data, bytes);
+      }
+
+      void writeString(const std::string& s) {
+            uint32_t length = s.size();
+            write(&length, sizeof(length));
+            write(s.data(), length);
+      }
+
+      void readString(std::string& s) {
+            uint32_t length = 0;
+            read(&length, sizeof(length));
+            if (!ok || length > (1u << 20)) {
+                  ok = false;
+                  return;
+            }
+            s.resize(length);
+            if (length > 0) read(&s[0], length);
+      }
+
+      FILE* file;
+      uint64_t hash;
+      bool ok;
+
+private:
+      void fold(const void* data, size_t bytes) {
+            const unsigned char* p = (const unsigned char*)data;
+            for (size_t i = 0; i < bytes; i++) hash = (hash ^ p[i]) * 0x100000001b3ULL;
+      }
+};
+
+inline bool saveSnapshot(const std::string& path, const SearchSnapshot& snapshot) {
+      std::string temporary = path + ".tmp";
+      FILE* f = fopen(temporary.c_str(), "wb");
+      if (!f) return false;
+      ChecksumFile file(f);
+      file.write(&SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+      file.writeString(snapshot.engine);
+      file.writeString(snapshot.start);
+      uint32_t counters = snapshot.counters.size();
+      file.write(&counters, sizeof(counters));
+      if (counters > 0) file.write(&snapshot.counters[0], counters * sizeof(int64_t));
+      uint32_t sections = snapshot.sections.size();
+      file.write(&sections, sizeof(sections));
+      for (size_t s = 0; s < snapshot.sections.size(); s++) {
+            const SnapshotSection& section = snapshot.sections[s];
+            uint64_t bytes = section.data.size();
+            file.writeString(section.name);
+            file.write(&section.elementSize, sizeof(section.elementSize));
+            file.write(&bytes, sizeof(bytes));
+            if (bytes > 0) file.write(&section.data[0], bytes);
+      }
+      uint64_t checksum = file.hash;
+      bool ok = file.ok && fwrite(&checksum, sizeof(checksum), 1, f) == 1;
+      ok = fclose(f) == 0 && ok;
+      return ok && rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @brief Reads a snapshot; false if the file is missing, truncated or corrupt
+ *        (the last two with a warning, the search then starts over)
+ */
+inline bool loadSnapshot(const std::string& path, SearchSnapshot& snapshot) {
+      FILE* f = fopen(path.c_str(), "rb");
+      if (!f) return false;
+      ChecksumFile file(f);
+      uint64_t magic = 0;
+      file.read(&magic, sizeof(magic));
+      file.ok = file.ok && magic == SNAPSHOT_MAGIC;
+      file.readString(snapshot.engine);
+      file.readString(snapshot.start);
+      uint32_t counters = 0;
+      file.read(&counters, sizeof(counters));
+      if (file.ok && counters <= 1024) {
+            snapshot.counters.resize(counters);
+            if (counters > 0) file.read(&snapshot.counters[0], counters * sizeof(int64_t));
+      } else {
+            file.ok = false;
+      }
+      uint32_t sections = 0;
+      file.read(&sections, sizeof(sections));
+      file.ok = file.ok && sections <= 1024;
+      snapshot.sections.clear();
+      for (uint32_t s = 0; file.ok && s < sections; s++) {
+            SnapshotSection section;
+            uint64_t bytes = 0;
+            file.readString(section.name);
+            file.read(&section.elementSize, sizeof(section.elementSize));
+            file.read(&bytes, sizeof(bytes));
+            if (!file.ok || section.elementSize == 0 || bytes % section.elementSize != 0) {
+                  file.ok = false;
+                  break;
+            }
+            section.data.resize(bytes);
+            if (bytes > 0) file.read(&section.data[0], bytes);
+            snapshot.sections.push_back(SnapshotSection());
+            snapshot.sections.back().name.swap(section.name);
+            snapshot.sections.back().elementSize = section.elementSize;
+            snapshot.sections.back().data.swap(section.data);
+      }
+      uint64_t expected = file.hash, checksum = 0;
+      bool ok = file.ok && fread(&checksum, sizeof(checksum), 1, f) == 1 && checksum == expected;
+      fclose(f);
+      if (!ok) fprintf(stderr, "Warning: ignoring invalid checkpoint %s\n", path.c_str());
+      return ok;
+}
+
+// =============================================================================
+// BACKGROUND WRITER
+// =============================================================================
+
+class CheckpointWriter {
+public:
+      /**
+       * @param path Snapshot file; empty disables checkpointing
+       * @param intervalSeconds Minimum time between two snapshots
+       */
+      CheckpointWriter(const std::string& path, double intervalSeconds)
+            : file(path), interval(intervalSeconds), pending(false), writing(false), quit(false),
+              writes(0), failures(0), bytesWritten(0), copySeconds(0), lastCopySeconds(0), writeSeconds(0),
+              lastSnapshot(std::chrono::steady_clock::now()) {
+            if (!file.empty()) worker = std::thread(&CheckpointWriter::run, this);
+      }
+
+      ~CheckpointWriter() {
+            finish();
+            if (worker.joinable()) {
+                  {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        quit = true;
+                  }
+                  wake.notify_all();
+                  worker.join();
+            }
+      }
+
+      bool enabled() const { return !file.empty(); }
+
+      const std::string& path() const { return file; }
+
+      /**
+       * @brief True when the search should build a snapshot now
+       */
+      bool due() {
+            if (file.empty()) return false;
+            double since = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastSnapshot).count();
+            if (since < interval || since * CHECKPOINT_COPY_BUDGET < lastCopySeconds) return false;
+            std::lock_guard<std::mutex> lock(mutex);
+            return !pending && !writing;
+      }
+
+      /**
+       * @brief Hands snapshot to the writer thread (its contents are taken, not copied)
+       * @param copyStarted When the search started filling the snapshot, for the statistics
+       */
+      void submit(SearchSnapshot& snapshot, std::chrono::steady_clock::time_point copyStarted) {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            {
+                  std::lock_guard<std::mutex> lock(mutex);
+                  lastCopySeconds = std::chrono::duration<double>(now - copyStarted).count();
+                  copySeconds += lastCopySeconds;
+                  queued.engine.swap(snapshot.engine);
+                  queued.start.swap(snapshot.start);
+                  queued.counters.swap(snapshot.counters);
+                  queued.sections.swap(snapshot.sections);
+                  pending = true;
+            }
+            snapshot.clear();
+            lastSnapshot = now;
+            wake.notify_all();
+      }
+
+      /**
+       * @brief Waits until the queued snapshot, if any, is on disk
+       */
+      void finish() {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return !pending && !writing; });
+      }
+
+      void printStats(std::ostream& out) {
+            finish();
+            out << "Checkpoints: " << writes << " written (" << failures << " failed), "
+                << bytesWritten / (1024 * 1024) << " MB, snapshot copy " << copySeconds << " s on the search thread, "
+                << writeSeconds << " s writing in the background" << std::endl;
+      }
+
+private:
+      void run() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                  wake.wait(lock, [this] { return pending || quit; });
+                  if (!pending) return;
+                  SearchSnapshot snapshot;
+                  snapshot.engine.swap(queued.engine);
+                  snapshot.start.swap(queued.start);
+                  snapshot.counters.swap(queued.counters);
+                  snapshot.sections.swap(queued.sections);
+                  pending = false;
+                  writing = true;
+                  lock.unlock();
+
+                  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                  bool ok = saveSnapshot(file, snapshot);
+                  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                  if (!ok) fprintf(stderr, "Error: cannot write checkpoint %s\n", file.c_str());
+
+                  lock.lock();
+                  writing = false;
+                  writeSeconds += seconds;
+                  if (ok) {
+                        writes++;
+                        bytesWritten += snapshot.bytes();
+                  } else {
+                        failures++;
+                  }
+                  done.notify_all();
+            }
+      }
+
+      std::string file;
+      double interval;
+      std::thread worker;
+      std::mutex mutex;
+      std::condition_variable wake;
+      std::condition_variable done;
+      SearchSnapshot queued;
+      bool pending;
+      bool writing;
+      bool quit;
+      int writes;
+      int failures;
+      uint64_t bytesWritten;
+      double copySeconds;
+      double lastCopySeconds;
+      double writeSeconds;
+      std::chrono::steady_clock::time_point lastSnapshot;
+};
+
+#endif // SEARCH_CHECKPOINT_H
@@ -0,0 +1,194 @@
+/**
+ * @file solved_state_cache.h
+ * @brief Persistent cache of exact distances to the goal, keyed by packed board
+ *
+ * After a solve, every state on the optimal path is recorded with its exact
+ * distance to the goal (not only the start state), so repeated and closely
+ * related puzzles are answered from the cache or hit it part-way through the
+ * search, where the exact value gives perfect pruning.
+ *
+ * The table lives in a file mapped with mmap(MAP_SHARED): it survives restarts
+ * and can be shared by several processes. Slots are claimed lock-free with a
+ * compare-and-swap on the key (open addressing, linear probing); the distance
+ * is stored as distance + 1 so that 0 means "being written".
+ *
+ * File layout:
+ *   CacheHeader | CacheEntry[capacity]
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef SOLVED_STATE_CACHE_H
+#define SOLVED_STATE_CACHE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "packed_board.h"
+
+class SolvedStateCache {
+public:
+      /**
+       * @brief Opens (or creates) the cache file
+       * @param capacity Number of slots for a new file, rounded up to a power of two;
+       *                 an existing file keeps its own capacity
+       */
+      SolvedStateCache(const std::string& path, size_t capacity)
+            : header(nullptr), entries(nullptr), mapping(nullptr), mappedBytes(0), hits(0), misses(0) {
+            size_t slots = 1;
+            while (slots < capacity) slots *= 2;
+
+            int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (fd < 0) {
+                  std::cerr << "Warning: cannot open cache file " << path << std::endl;
+                  return;
+            }
+
+            struct stat info;
+            fstat(fd, &info);
+            bool fresh = info.st_size < (off_t)sizeof(CacheHeader);
+            if (!fresh) {
+                  CacheHeader existing;
+                  if (pread(fd, &existing, sizeof(existing), 0) == (ssize_t)sizeof(existing)
+                      && existing.magic == MAGIC && existing.version == VERSION) {
+                        slots = existing.capacity;
+                  } else {
+                        fresh = true;
+                  }
+            }
+
+            mappedBytes = sizeof(CacheHeader) + slots * sizeof(CacheEntry);
+            if (fresh && ftruncate(fd, 0) != 0) mappedBytes = 0;
+            if (mappedBytes == 0 || ftruncate(fd, mappedBytes) != 0) {
+                  std::cerr << "Warning: cannot size cache file " << path << std::endl;
+                  close(fd);
+                  return;
+            }
+
+            void* memory = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (memory == MAP_FAILED) {
+                  std::cerr << "Warning: cannot map cache file " << path << std::endl;
+                  return;
+            }
+
+            mapping = memory;
+            header = (CacheHeader*)memory;
+            entries = (CacheEntry*)((char*)memory + sizeof(CacheHeader));
+            if (fresh) {
+                  header->magic = MAGIC;
+                  header->version = VERSION;
+                  header->capacity = slots;
+                  header->count = 0;
+            }
+            mask = header->capacity - 1;
+      }
+
+      ~SolvedStateCache() {
+            if (mapping) {
+                  msync(mapping, mappedBytes, MS_ASYNC);
+                  munmap(mapping, mappedBytes);
+            }
+      }
+
+      bool isOpen() const { return mapping != nullptr; }
+
+      /**
+       * @brief Looks up the exact distance to the goal of a board
+       */
+      bool lookup(PackedBoard key, int& distance) {
+            if (!mapping) return false;
+            size_t idx = index(key);
+            for (int probe = 0; probe < MAX_PROBES; probe++) {
+                  CacheEntry& e = entries[(idx + probe) & mask];
+                  uint64_t stored = __atomic_load_n(&e.key, __ATOMIC_ACQUIRE);
+                  if (stored == 0) break;
+                  if (stored == key) {
+                        uint64_t value = __atomic_load_n(&e.value, __ATOMIC_ACQUIRE);
+                        if (value == 0) break;
+                        distance = (int)(value - 1);
+                        __atomic_fetch_add(&hits, 1, __ATOMIC_RELAXED);
+                        return true;
+                  }
+            }
+            __atomic_fetch_add(&misses, 1, __ATOMIC_RELAXED);
+            return false;
+      }
+
+      /**
+       * @brief Records the exact distance of a board (no-op if already present or full)
+       */
+      void insert(PackedBoard key, int distance) {
+            if (!mapping) return;
+            size_t idx = index(key);
+            for (int probe = 0; probe < MAX_PROBES; probe++) {
+                  CacheEntry& e = entries[(idx + probe) & mask];
+                  uint64_t expected = 0;
+                  if (__atomic_compare_exchange_n(&e.key, &expected, key, false,
+                                                  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                        __atomic_store_n(&e.value, (uint64_t)distance + 1, __ATOMIC_RELEASE);
+                        __atomic_fetch_add(&header->count, 1, __ATOMIC_RELAXED);
+                        return;
+                  }
+                  if (expected == key) return;
+            }
+      }
+
+      /**
+       * @brief Records every state of a path that ends at a known distance
+       * @param path States from the start towards the goal
+       * @param distanceOfLast Exact distance to the goal of the last state (0 if it is the goal)
+       */
+      void recordPath(const std::vector<PackedBoard>& path, int distanceOfLast = 0) {
+            int n = path.size();
+            for (int i = 0; i < n; i++) {
+                  insert(path[i], distanceOfLast + (n - 1 - i));
+            }
+      }
+
+      void printStats(std::ostream& out) const {
+            if (!mapping) return;
+            out << "Cache entries: " << header->count << " / " << header->capacity
+                << ", hits: " << hits << ", misses: " << misses << std::endl;
+      }
+
+private:
+      static const uint32_t MAGIC = 0x43535A50;  // "PZSC"
+      static const uint32_t VERSION = 1;
+      static const int MAX_PROBES = 32;
+
+      struct CacheHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t capacity;
+            uint64_t count;
+            uint64_t reserved;
+      };
+
+      struct CacheEntry {
+            uint64_t key;    // packed board, 0 = empty (a real board always has a blank nibble)
+            uint64_t value;  // distance + 1, 0 = being written
+      };
+
+      size_t index(PackedBoard key) const {
+            uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+            return (size_t)(h >> 32) & mask;
+      }
+
+      CacheHeader* header;
+      CacheEntry* entries;
+      void* mapping;
+      size_t mappedBytes;
+      size_t mask;
+      uint64_t hits;
+      uint64_t misses;
+};
+
+#endif // SOLVED_STATE_CACHE_H
@@ -0,0 +1,36 @@
+/**
+ * @file stop_token.h
+ * @brief Shared cooperative cancellation flag for search loops
+ *
+ * A search that accepts a StopToken polls stopRequested() from its expansion
+ * loop (every few hundred nodes is enough) and returns early once it is set.
+ * Nothing is interrupted: the owner raises the flag and waits for the search
+ * to notice it and return, so every search leaves its data consistent.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef STOP_TOKEN_H
+#define STOP_TOKEN_H
+
+#include <atomic>
+
+class StopToken {
+public:
+      StopToken() : flag(false) {}
+
+      void requestStop() { flag.store(true, std::memory_order_relaxed); }
+
+      bool stopRequested() const { return flag.load(std::memory_order_relaxed); }
+
+      void reset() { flag.store(false, std::memory_order_relaxed); }
+
+private:
+      StopToken(const StopToken&);
+      StopToken& operator=(const StopToken&);
+
+      std::atomic<bool> flag;
+};
+
+#endif // STOP_TOKEN_H
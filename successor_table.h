@@ -0,0 +1,158 @@
+/**
+ * @file successor_table.h
+ * @brief Precomputed blank moves of every cell of an MxN board
+ *
+ * Every solver used to find the legal moves of the blank with the same four
+ * bounds checks (row + dRow[i], col + dCol[i] inside the board). The table
+ * does those checks once per board shape: for each cell it stores the legal
+ * moves as a bitmask and as a packed list of (move, target cell) pairs, so
+ * a generator loops only over moves that exist:
+ *
+ *   const SuccessorTable& moves = SuccessorTable::square(n);
+ *   for (int k = 0; k < moves.count(blank); k++) {
+ *         int move = moves.move(blank, k);       // 0=UP 1=DOWN 2=LEFT 3=RIGHT
+ *         int target = moves.neighbor(blank, k);  // cell the blank moves to
+ *         ...
+ *   }
+ *
+ * The per-cell values come from the constexpr functions successorTarget()
+ * and successorMask(), which also give compile-time answers for a fixed
+ * shape. Moves are numbered as in move_pruning_table.h. legalMoves() is the
+ * bulk form: the move masks of whole arrays of blank cells or boards.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef SUCCESSOR_TABLE_H
+#define SUCCESSOR_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const int MOVE_UP = 0;
+const int MOVE_DOWN = 1;
+const int MOVE_LEFT = 2;
+const int MOVE_RIGHT = 3;
+
+/**
+ * @brief Cell the blank reaches from cell by move, or -1 if it leaves the board
+ */
+constexpr int successorTarget(int rows, int cols, int cell, int move) {
+      return move == MOVE_UP    ? (cell >= cols ? cell - cols : -1)
+           : move == MOVE_DOWN  ? (cell < (rows - 1) * cols ? cell + cols : -1)
+           : move == MOVE_LEFT  ? (cell % cols > 0 ? cell - 1 : -1)
+           : move == MOVE_RIGHT ? (cell % cols < cols - 1 ? cell + 1 : -1)
+           : -1;
+}
+
+/**
+ * @brief Legal moves of the blank at cell, bit m set for move m
+ */
+constexpr unsigned successorMask(int rows, int cols, int cell) {
+      return (successorTarget(rows, cols, cell, MOVE_UP) >= 0 ? 1u : 0u)
+           | (successorTarget(rows, cols, cell, MOVE_DOWN) >= 0 ? 2u : 0u)
+           | (successorTarget(rows, cols, cell, MOVE_LEFT) >= 0 ? 4u : 0u)
+           | (successorTarget(rows, cols, cell, MOVE_RIGHT) >= 0 ? 8u : 0u);
+}
+
+class SuccessorTable {
+public:
+      static const int MAX_SIDE = 10;
+
+      SuccessorTable(int rowCount, int colCount)
+            : rows(rowCount), cols(colCount), counts(rowCount * colCount), masks(rowCount * colCount),
+              moves(rowCount * colCount * 4), neighbors(rowCount * colCount * 4), targets(rowCount * colCount * 4) {
+            for (int cell = 0; cell < rows * cols; cell++) {
+                  masks[cell] = successorMask(rows, cols, cell);
+                  int k = 0;
+                  for (int move = 0; move < 4; move++) {
+                        int target = successorTarget(rows, cols, cell, move);
+                        targets[cell * 4 + move] = target;
+                        if (target < 0) continue;
+                        moves[cell * 4 + k] = move;
+                        neighbors[cell * 4 + k] = target;
+                        k++;
+                  }
+                  counts[cell] = k;
+            }
+      }
+
+      /**
+       * @brief Shared table of the NxN board; any other n than 2..MAX_SIDE is a
+       *        caller bug and aborts with a message
+       */
+      static const SuccessorTable& square(int n) {
+            if (n < 2 || n > MAX_SIDE) {
+                  std::cerr << "Error: SuccessorTable::square(" << n << "): side must be 2 to " << (int)MAX_SIDE << std::endl;
+                  std::abort();
+            }
+            static const std::vector<SuccessorTable> tables = buildSquares();
+            return tables[n];
+      }
+
+      int rowCount() const { return rows; }
+
+      int colCount() const { return cols; }
+
+      int cells() const { return rows * cols; }
+
+      /** @brief Number of legal moves of the blank at cell */
+      int count(int cell) const { return counts[cell]; }
+
+      /** @brief k-th legal move of the blank at cell (k < count(cell)), in move order */
+      int move(int cell, int k) const { return moves[cell * 4 + k]; }
+
+      /** @brief Cell the blank reaches with the k-th legal move */
+      int neighbor(int cell, int k) const { return neighbors[cell * 4 + k]; }
+
+      /** @brief Cell the blank reaches with move, -1 if it leaves the board */
+      int target(int cell, int move) const { return targets[cell * 4 + move]; }
+
+      /** @brief Legal moves of the blank at cell as a bitmask (bit m = move m) */
+      unsigned mask(int cell) const { return masks[cell]; }
+
+      /**
+       * @brief Move masks of count blank cells
+       */
+      void legalMoves(const uint8_t* blankCells, size_t count, uint8_t* out) const {
+            for (size_t i = 0; i < count; i++) out[i] = masks[blankCells[i]];
+      }
+
+      /**
+       * @brief Move masks of boards given as strings ('#' is the blank)
+       */
+      void legalMoves(const std::vector<std::string>& boards, std::vector<uint8_t>& out) const {
+            out.resize(boards.size());
+            for (size_t i = 0; i < boards.size(); i++) out[i] = masks[boards[i].find('#')];
+      }
+
+      static const char* moveName(int move) {
+            static const char* names[] = {"UP", "DOWN", "LEFT", "RIGHT"};
+            return names[move];
+      }
+
+      /** @brief One-letter blank move, as in move_pruning_generator.cpp */
+      static char moveLetter(int move) { return "UDLR"[move]; }
+
+private:
+      static std::vector<SuccessorTable> buildSquares() {
+            std::vector<SuccessorTable> tables;
+            for (int n = 0; n <= MAX_SIDE; n++) tables.push_back(SuccessorTable(n, n));
+            return tables;
+      }
+
+      int rows;
+      int cols;
+      std::vector<uint8_t> counts;
+      std::vector<uint8_t> masks;
+      std::vector<uint8_t> moves;
+      std::vector<int16_t> neighbors;
+      std::vector<int16_t> targets;
+};
+
+#endif // SUCCESSOR_TABLE_H
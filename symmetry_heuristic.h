@@ -0,0 +1,185 @@
+/**
+ * @file symmetry_heuristic.h
+ * @brief Additive pattern database with reflected and dual lookups for the 4x4 puzzle
+ *
+ * The goal "ABCDEFGHIJKLMNO#" is symmetric about the main diagonal, so the
+ * board reflected across that diagonal (tiles relabelled by the same
+ * reflection) is exactly as far from the goal as the original board. Its
+ * estimate is a second admissible bound and we keep the maximum.
+ *
+ * The database uses one pattern per goal row ({A,B,C,D}, {E,F,G,H},
+ * {I,J,K,L}, {M,N,O}). Looking up the reflected board in the row database is
+ * the same as looking up the original board in a column database, so only
+ * this canonical half is stored and the column half comes for free.
+ *
+ * The dual board is the inverse permutation (dual[tile] = cell of that tile).
+ * Reversing a solution of the board solves the dual only when the blank
+ * starts on its goal cell, so the dual lookup is applied only in that case.
+ *
+ * For plain Manhattan distance the three lookups always agree, which is why
+ * calculateH2 is left unchanged; the gain comes from the table.
+ *
+ * Tiles are assumed to use the canonical labels (A = 0 .. O = 14, blank = 15)
+ * so that a tile value is also its goal cell; custom goals are relabelled onto
+ * TARGET first (goal_relabel.h).
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef SYMMETRY_HEURISTIC_H
+#define SYMMETRY_HEURISTIC_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "packed_board.h"
+#include "successor_table.h"
+
+/**
+ * @brief Reflects a canonical 4x4 board across the main diagonal
+ */
+inline PackedBoard reflectBoard(PackedBoard board) {
+      PackedBoard reflected = 0;
+      for (int pos = 0; pos < 16; pos++) {
+            int tile = packedTile(board, pos);
+            int reflectedPos = (pos % 4) * 4 + pos / 4;
+            int reflectedTile = (tile % 4) * 4 + tile / 4;  // the blank (15) maps to itself
+            reflected |= (PackedBoard)reflectedTile << (4 * reflectedPos);
+      }
+      return reflected;
+}
+
+/**
+ * @brief Inverse permutation of a canonical 4x4 board: dual[tile] = cell
+ */
+inline PackedBoard dualBoard(PackedBoard board) {
+      PackedBoard dual = 0;
+      for (int pos = 0; pos < 16; pos++) {
+            dual |= (PackedBoard)pos << (4 * packedTile(board, pos));
+      }
+      return dual;
+}
+
+class SymmetricPatternDatabase {
+public:
+      /**
+       * @brief Builds the row patterns with a 0-1 BFS backwards from the goal
+       */
+      SymmetricPatternDatabase() {
+            for (int p = 0; p < PATTERNS; p++) {
+                  int first = p * 4;
+                  int size = (p == PATTERNS - 1) ? 3 : 4;
+                  patternSize[p] = size;
+                  for (int i = 0; i < size; i++) patternTiles[p][i] = first + i;
+                  buildPattern(p);
+            }
+      }
+
+      /**
+       * @brief max(h(board), h(reflected board), h(dual board) if the blank is home)
+       */
+      int estimate(PackedBoard board) const {
+            int best = lookup(board);
+
+            int reflected = lookup(reflectBoard(board));
+            if (reflected > best) best = reflected;
+
+            if (packedTile(board, 15) == PACKED_BLANK) {
+                  int dual = lookup(dualBoard(board));
+                  if (dual > best) best = dual;
+            }
+            return best;
+      }
+
+      /**
+       * @brief Additive row-pattern estimate of one board (no symmetry)
+       */
+      int lookup(PackedBoard board) const {
+            int positions[16];
+            for (int pos = 0; pos < 16; pos++) positions[packedTile(board, pos)] = pos;
+
+            int total = 0;
+            for (int p = 0; p < PATTERNS; p++) {
+                  int index = 0;
+                  for (int i = 0; i < patternSize[p]; i++) {
+                        index = index * 16 + positions[patternTiles[p][i]];
+                  }
+                  total += tables[p][index];
+            }
+            return total;
+      }
+
+      size_t bytes() const {
+            size_t total = 0;
+            for (int p = 0; p < PATTERNS; p++) total += tables[p].size();
+            return total;
+      }
+
+private:
+      static const int PATTERNS = 4;
+
+      /**
+       * @brief Fills tables[p] with the moves of the pattern tiles needed to
+       *        reach their goal cells (blank moves are free, so the patterns add up)
+       */
+      void buildPattern(int p) {
+            int size = patternSize[p];
+            int cells = 1;
+            for (int i = 0; i < size; i++) cells *= 16;
+            tables[p].assign(cells, 255);
+
+            // Search state: pattern positions (base 16) followed by the blank position
+            std::vector<uint8_t> distance(cells * 16, 255);
+            std::deque<int> queue;
+
+            int goalIndex = 0;
+            for (int i = 0; i < size; i++) goalIndex = goalIndex * 16 + patternTiles[p][i];
+            distance[goalIndex * 16 + 15] = 0;
+            queue.push_back(goalIndex * 16 + 15);
+
+            const SuccessorTable& moves = SuccessorTable::square(4);
+            int positions[4];
+
+            while (!queue.empty()) {
+                  int state = queue.front();
+                  queue.pop_front();
+                  int blank = state % 16;
+                  int index = state / 16;
+                  int dist = distance[state];
+
+                  if (dist < tables[p][index]) tables[p][index] = dist;
+
+                  for (int i = size - 1, rest = index; i >= 0; i--, rest /= 16) positions[i] = rest % 16;
+
+                  for (int m = 0; m < moves.count(blank); m++) {
+                        int newBlank = moves.neighbor(blank, m);
+
+                        // Swapping with a pattern tile costs one move, otherwise nothing
+                        int moved = -1;
+                        for (int i = 0; i < size; i++) {
+                              if (positions[i] == newBlank) moved = i;
+                        }
+
+                        int newIndex = 0;
+                        for (int i = 0; i < size; i++) {
+                              newIndex = newIndex * 16 + (i == moved ? blank : positions[i]);
+                        }
+                        int next = newIndex * 16 + newBlank;
+                        int cost = (moved >= 0) ? 1 : 0;
+
+                        if (dist + cost < distance[next]) {
+                              distance[next] = dist + cost;
+                              if (cost == 0) queue.push_front(next);
+                              else queue.push_back(next);
+                        }
+                  }
+            }
+      }
+
+      std::vector<uint8_t> tables[PATTERNS];
+      int patternTiles[PATTERNS][4];
+      int patternSize[PATTERNS];
+};
+
+#endif // SYMMETRY_HEURISTIC_H
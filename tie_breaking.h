@@ -0,0 +1,73 @@
+/**
+ * @file tie_breaking.h
+ * @brief Run-time selectable tie-breaking among open-list states with equal f
+ *
+ * On unit-cost puzzles most of the final f-layer shares one f value, so the
+ * order among equal-f states decides how much of that layer is expanded
+ * before the goal is popped. Policies:
+ *
+ *   any     Order by f only (the original behaviour, ties in arbitrary order)
+ *   high-g  Prefer the deeper state (equivalently lower h, since f = g + h;
+ *           "low-h" is accepted as an alias)
+ *   lifo    Prefer the most recently generated state
+ *   fifo    Prefer the oldest state (for comparison)
+ *
+ * TieBreakCompare<State> is a "worse than" comparator: it is the comparator
+ * of a min priority_queue and the greater<State> replacement for the
+ * parallel solvers, which sort descending and take the batch from the back.
+ * State needs f(), cost, heuristic and order (insertion sequence number).
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef TIE_BREAKING_H
+#define TIE_BREAKING_H
+
+#include <cstring>
+
+enum TieBreakPolicy {
+      TIE_ANY,
+      TIE_HIGH_G,
+      TIE_LIFO,
+      TIE_FIFO
+};
+
+/**
+ * @brief Parses a policy name; false if it is unknown
+ */
+inline bool parseTieBreakPolicy(const char* name, TieBreakPolicy& policy) {
+      if (strcmp(name, "any") == 0) policy = TIE_ANY;
+      else if (strcmp(name, "high-g") == 0 || strcmp(name, "low-h") == 0) policy = TIE_HIGH_G;
+      else if (strcmp(name, "lifo") == 0) policy = TIE_LIFO;
+      else if (strcmp(name, "fifo") == 0) policy = TIE_FIFO;
+      else return false;
+      return true;
+}
+
+inline const char* tieBreakName(TieBreakPolicy policy) {
+      static const char* names[] = {"any", "high-g", "lifo", "fifo"};
+      return names[policy];
+}
+
+/**
+ * @brief true if a must be expanded after b
+ */
+template <class State>
+struct TieBreakCompare {
+      TieBreakPolicy policy;
+
+      explicit TieBreakCompare(TieBreakPolicy p = TIE_ANY) : policy(p) {}
+
+      bool operator()(const State& a, const State& b) const {
+            if (a.f() != b.f()) return a.f() > b.f();
+            switch (policy) {
+                  case TIE_HIGH_G: return a.cost < b.cost;
+                  case TIE_LIFO:   return a.order < b.order;
+                  case TIE_FIFO:   return a.order > b.order;
+                  default:         return false;
+            }
+      }
+};
+
+#endif // TIE_BREAKING_H
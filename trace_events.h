@@ -0,0 +1,176 @@
+/**
+ * @file trace_events.h
+ * @brief Per-thread timeline tracing written as Chrome/Perfetto trace JSON
+ *
+ * Compiled in only with -DPUZZLE_TRACE; otherwise every macro expands to
+ * nothing and this header adds no code, data or includes.
+ *
+ * Each thread records into its own fixed-size ring buffer (single writer, no
+ * locks or atomics on the recording path; registration of a new thread takes
+ * a lock once). When a ring is full the oldest events are overwritten and
+ * counted as dropped. At exit all rings are written to the file named by the
+ * PUZZLE_TRACE_FILE environment variable (default puzzle_trace.json), which
+ * opens directly in chrome://tracing or ui.perfetto.dev.
+ *
+ * Macros (names must be string literals):
+ *   TRACE_BEGIN(name) / TRACE_END(name)  Duration slice on the calling thread
+ *   TRACE_SCOPE(name)                    Slice covering the enclosing block
+ *   TRACE_INSTANT(name)                  Point event (e.g. a level boundary)
+ *
+ * Example:
+ *   g++ -std=c++11 -O2 -fopenmp -DPUZZLE_TRACE -o pa2 parallel_astar_h2_openmp.cpp
+ *   echo "EABCM#GDKFILNOJH" | PUZZLE_TRACE_FILE=astar.json ./pa2 4
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+#ifdef PUZZLE_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+struct Event {
+      const char* name;
+      uint64_t timestampNs;
+      char phase;  // 'B' begin, 'E' end, 'i' instant
+};
+
+/**
+ * @brief Ring buffer of one thread (only that thread writes it)
+ */
+struct ThreadBuffer {
+      static const size_t CAPACITY = 1 << 18;
+
+      std::vector<Event> events;
+      uint64_t written;
+      int threadId;
+
+      explicit ThreadBuffer(int id) : events(CAPACITY), written(0), threadId(id) {}
+
+      void record(const char* name, char phase, uint64_t timestampNs) {
+            Event& e = events[written % CAPACITY];
+            e.name = name;
+            e.phase = phase;
+            e.timestampNs = timestampNs;
+            written++;
+      }
+};
+
+/**
+ * @brief Owns every thread buffer and writes the trace file at exit
+ */
+class Registry {
+public:
+      Registry() : origin(std::chrono::steady_clock::now()) {}
+
+      ~Registry() {
+            write();
+            for (size_t i = 0; i < buffers.size(); i++) delete buffers[i];
+      }
+
+      ThreadBuffer* add() {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.push_back(new ThreadBuffer(buffers.size()));
+            return buffers.back();
+      }
+
+      uint64_t now() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - origin).count();
+      }
+
+private:
+      void write() {
+            const char* path = getenv("PUZZLE_TRACE_FILE");
+            if (!path) path = "puzzle_trace.json";
+            FILE* file = fopen(path, "w");
+            if (!file) {
+                  fprintf(stderr, "Warning: cannot write trace file %s\n", path);
+                  return;
+            }
+
+            uint64_t total = 0, dropped = 0;
+            bool first = true;
+            fprintf(file, "{\"traceEvents\":[\n");
+            for (size_t b = 0; b < buffers.size(); b++) {
+                  const ThreadBuffer& buffer = *buffers[b];
+                  fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                          "\"args\":{\"name\":\"thread %d\"}}", first ? "" : ",\n",
+                          buffer.threadId, buffer.threadId);
+                  first = false;
+
+                  // Oldest surviving event first
+                  uint64_t begin = buffer.written > ThreadBuffer::CAPACITY
+                                 ? buffer.written - ThreadBuffer::CAPACITY : 0;
+                  dropped += begin;
+                  for (uint64_t i = begin; i < buffer.written; i++) {
+                        const Event& e = buffer.events[i % ThreadBuffer::CAPACITY];
+                        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d%s}",
+                                e.name, e.phase, e.timestampNs / 1000.0, buffer.threadId,
+                                e.phase == 'i' ? ",\"s\":\"t\"" : "");
+                        total++;
+                  }
+            }
+            fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+            fclose(file);
+            fprintf(stderr, "Trace written to %s (%llu events, %llu dropped)\n", path,
+                    (unsigned long long)total, (unsigned long long)dropped);
+      }
+
+      std::chrono::steady_clock::time_point origin;
+      std::vector<ThreadBuffer*> buffers;
+      std::mutex mutex;
+};
+
+inline Registry& registry() {
+      static Registry instance;
+      return instance;
+}
+
+inline void record(const char* name, char phase) {
+      static thread_local ThreadBuffer* buffer = registry().add();
+      buffer->record(name, phase, registry().now());
+}
+
+/**
+ * @brief Begins a slice on construction and ends it on destruction
+ */
+class ScopedSlice {
+public:
+      explicit ScopedSlice(const char* n) : name(n) { record(name, 'B'); }
+      ~ScopedSlice() { record(name, 'E'); }
+
+private:
+      const char* name;
+};
+
+} // namespace trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#define TRACE_BEGIN(name) trace::record(name, 'B')
+#define TRACE_END(name) trace::record(name, 'E')
+#define TRACE_INSTANT(name) trace::record(name, 'i')
+#define TRACE_SCOPE(name) trace::ScopedSlice TRACE_CONCAT(traceSlice, __LINE__)(name)
+
+#else
+
+#define TRACE_BEGIN(name) do {} while (0)
+#define TRACE_END(name) do {} while (0)
+#define TRACE_INSTANT(name) do {} while (0)
+#define TRACE_SCOPE(name) do {} while (0)
+
+#endif // PUZZLE_TRACE
+
+#endif // TRACE_EVENTS_H
@@ -0,0 +1,177 @@
+/**
+ * @file transposition_table.h
+ * @brief Fixed-size lock-free transposition table shared by all search threads
+ *
+ * Stores, for a packed board, the best known lower bound on its distance to
+ * the goal. Entries are two 64-bit words written with relaxed atomics; the
+ * first word holds key XOR data, so a torn read (key from one writer, data
+ * from another) simply fails validation and is treated as a miss.
+ *
+ * Replacement policy (depth/threshold preferred): a slot is overwritten when
+ * it is empty, holds the same board, was written during an older iteration
+ * (threshold), or holds a result searched with less remaining depth.
+ *
+ * Hit/miss/collision counters are kept per thread stripe so tuning the size
+ * does not add a contended cache line to every probe.
+ *
+ * @author JAPeTo
+ * @version 1.0
+ */
+
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include "packed_board.h"
+
+class TranspositionTable {
+public:
+      /**
+       * @brief Creates a table using at most the given memory budget
+       * @param bytes Memory budget; the entry count is rounded down to a power of two
+       */
+      explicit TranspositionTable(size_t bytes) : generation(1) {
+            size_t count = 1;
+            int bits = 0;
+            while (count * 2 * sizeof(Entry) <= bytes) {
+                  count *= 2;
+                  bits++;
+            }
+            numEntries = count;
+            shift = 64 - bits;
+            entries.reset(new Entry[count]);
+            for (size_t i = 0; i < count; i++) {
+                  entries[i].check.store(0, std::memory_order_relaxed);
+                  entries[i].data.store(0, std::memory_order_relaxed);
+            }
+            for (int s = 0; s < STRIPES; s++) {
+                  counters[s].hits.store(0, std::memory_order_relaxed);
+                  counters[s].misses.store(0, std::memory_order_relaxed);
+                  counters[s].collisions.store(0, std::memory_order_relaxed);
+                  counters[s].stores.store(0, std::memory_order_relaxed);
+            }
+      }
+
+      /**
+       * @brief Looks up the stored lower bound of a board
+       * @return true and sets bound if the board is present
+       */
+      bool probe(PackedBoard key, int& bound) {
+            Entry& e = entries[index(key)];
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            uint64_t check = e.check.load(std::memory_order_relaxed);
+            Counters& c = counters[stripe()];
+
+            if (data != 0 && (check ^ data) == key) {
+                  bound = (int)(data & 0xFF);
+                  c.hits.fetch_add(1, std::memory_order_relaxed);
+                  return true;
+            }
+            if (data != 0) {
+                  c.collisions.fetch_add(1, std::memory_order_relaxed);
+            }
+            c.misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+      }
+
+      /**
+       * @brief Stores a lower bound for a board
+       * @param depth Remaining search depth (threshold - g) that produced the bound
+       */
+      void store(PackedBoard key, int bound, int depth) {
+            if (bound > 255) bound = 255;
+            if (depth < 0) depth = 0;
+            if (depth > 255) depth = 255;
+
+            Entry& e = entries[index(key)];
+            uint64_t oldData = e.data.load(std::memory_order_relaxed);
+            uint64_t oldCheck = e.check.load(std::memory_order_relaxed);
+            uint32_t gen = generation.load(std::memory_order_relaxed);
+
+            if (oldData != 0 && (oldCheck ^ oldData) != key) {
+                  int oldDepth = (int)((oldData >> 8) & 0xFF);
+                  uint32_t oldGen = (uint32_t)((oldData >> 16) & 0xFF);
+                  if (oldGen == (gen & 0xFF) && oldDepth > depth) return;
+            }
+
+            uint64_t data = (uint64_t)bound | ((uint64_t)depth << 8)
+                          | ((uint64_t)(gen & 0xFF) << 16) | ((uint64_t)1 << 63);
+            e.check.store(key ^ data, std::memory_order_relaxed);
+            e.data.store(data, std::memory_order_relaxed);
+            counters[stripe()].stores.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Starts a new iteration; older entries become preferred victims
+       */
+      void newIteration() {
+            generation.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      size_t capacity() const { return numEntries; }
+
+      size_t bytes() const { return numEntries * sizeof(Entry); }
+
+      /**
+       * @brief Prints hit/miss/collision counters (for sizing the table)
+       */
+      void printStats(std::ostream& out) const {
+            uint64_t hits = 0, misses = 0, collisions = 0, stores = 0;
+            for (int s = 0; s < STRIPES; s++) {
+                  hits += counters[s].hits.load(std::memory_order_relaxed);
+                  misses += counters[s].misses.load(std::memory_order_relaxed);
+                  collisions += counters[s].collisions.load(std::memory_order_relaxed);
+                  stores += counters[s].stores.load(std::memory_order_relaxed);
+            }
+            uint64_t probes = hits + misses;
+            out << "TT entries: " << numEntries << " (" << bytes() / (1024 * 1024) << " MB)" << std::endl;
+            out << "TT probes: " << probes << ", hits: " << hits
+                << ", misses: " << misses << ", collisions: " << collisions
+                << ", stores: " << stores << std::endl;
+            if (probes > 0) {
+                  out << "TT hit rate: " << (100.0 * hits / probes) << "%, collision rate: "
+                      << (100.0 * collisions / probes) << "%" << std::endl;
+            }
+      }
+
+private:
+      struct Entry {
+            std::atomic<uint64_t> check; // key ^ data
+            std::atomic<uint64_t> data;  // bound:8 | depth:8 | generation:8 | valid bit 63
+      };
+
+      static const int STRIPES = 64;
+
+      // Padded to one cache line per stripe to avoid false sharing between threads
+      struct Counters {
+            std::atomic<uint64_t> hits;
+            std::atomic<uint64_t> misses;
+            std::atomic<uint64_t> collisions;
+            std::atomic<uint64_t> stores;
+            char padding[64 - 4 * sizeof(std::atomic<uint64_t>)];
+      };
+
+      // Fibonacci hashing: the high bits of the product mix every nibble
+      size_t index(PackedBoard key) const {
+            if (shift == 64) return 0;
+            return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> shift);
+      }
+
+      static int stripe() {
+            static std::atomic<int> nextStripe(0);
+            static thread_local int id = nextStripe.fetch_add(1) % STRIPES;
+            return id;
+      }
+
+      std::unique_ptr<Entry[]> entries;
+      size_t numEntries;
+      int shift;
+      std::atomic<uint32_t> generation;
+      Counters counters[STRIPES];
+};
+
+#endif // TRANSPOSITION_TABLE_H